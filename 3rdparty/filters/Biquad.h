@@ -14,6 +14,8 @@
 // - Removed useless functions (like setQ() et cetera)
 // - Added 'none' type (user's responsibility to *not* call process() or processMono())
 // - Minor optimizations
+// - Only recalculate tan() if the frequency changes
+// - Added direct access to coefficients & state (for vectorized processing, see synth-mini-EQ.cpp)
 // - Bug fix: swapped shelf filter coeff. calculations
 //
 // IMPORTANT:
@@ -91,6 +93,21 @@ public:
 		return m_type;
 	}
 
+	SFM_INLINE void getCoefficients(float &A0, float &A1, float &A2, float &B1, float &B2) const
+	{
+		A0 = a0; A1 = a1; A2 = a2; B1 = b1; B2 = b2;
+	}
+
+	SFM_INLINE void getState(float &Z1L, float &Z2L, float &Z1R, float &Z2R) const
+	{
+		Z1L = z1l; Z2L = z2l; Z1R = z1r; Z2R = z2r;
+	}
+
+	SFM_INLINE void setState(float Z1L, float Z2L, float Z1R, float Z2R)
+	{
+		z1l = Z1L; z2l = Z2L; z1r = Z1R; z2r = Z2R;
+	}
+
 protected:
 	void calcBiquad(void);
 
@@ -140,8 +157,12 @@ SFM_INLINE void Biquad::setBiquad(int type, float Fc, float Q, float peakGaindB)
 	// z1r = z2r = 0.f; // (R)
 
 	m_Q = Q;
-	m_Fc = Fc;
-	m_FcK = tanf(SFM::kPI*m_Fc);
+
+	if (m_Fc != Fc) // Often constant (EQ), so skip tanf() if possible
+	{
+		m_Fc = Fc;
+		m_FcK = tanf(SFM::kPI*m_Fc);
+	}
 
 	if (m_peakGain != peakGaindB) // Looks like it'll be worth the branch
 	{
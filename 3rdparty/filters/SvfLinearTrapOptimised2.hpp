@@ -7,6 +7,7 @@
 // - Stereo support (monaural remains, see tickMono())
 // - Added specific setup functions
 // - Added getFilterType()
+// - Added updateCoefficientsGK() (precalculated 'g' & 'k', see synth-control-rate-SVF.h)
 // - Ported to single precision (comments not modified)
 // 
 // - Stable Q range of [0.025..40] is gauranteed, but for stability using the default Q of 0.5
@@ -110,6 +111,11 @@ public:
 	SFM_INLINE void updateNone() {
 		_coef.updateNone();
 	}
+
+	// Precalculated g = tan(PI*cutoff/sampleRate) & k = 1/Q, bell & shelf filters are not supported
+	SFM_INLINE void updateCoefficientsGK(float g, float k, FLT_TYPE type) {
+		_coef.updateGK(g, k, type);
+	}
 	
 	// This copies *only* the coefficients of the specified filter, use at your own risk
 	SFM_INLINE void updateCopy(const SvfLinearTrapOptimised2 &filter)
@@ -215,6 +221,49 @@ private:
 		{
 			_type = SvfLinearTrapOptimised2::NO_FLT_TYPE;
 		}
+
+		SFM_INLINE void updateGK(float g, float k, SvfLinearTrapOptimised2::FLT_TYPE type)
+		{
+			computeA(g, k);
+
+			switch (type) {
+				case LOW_PASS_FILTER:
+					_m0 = 0;
+					_m1 = 0;
+					_m2 = 1;
+					break;
+				case BAND_PASS_FILTER:
+					_m0 = 0;
+					_m1 = 1;
+					_m2 = 0;
+					break;
+				case HIGH_PASS_FILTER:
+					_m0 = 1;
+					_m1 = -k;
+					_m2 = -1;
+					break;
+				case NOTCH_FILTER:
+					_m0 = 1;
+					_m1 = -k;
+					_m2 = 0;
+					break;
+				case PEAK_FILTER:
+					_m0 = 1;
+					_m1 = -k;
+					_m2 = -2;
+					break;
+				case ALL_PASS_FILTER:
+					_m0 = 1;
+					_m1 = -2*k;
+					_m2 = 0;
+					break;
+
+				default:
+					SFM_ASSERT(false);
+			}
+
+			_type = type;
+		}
 		
 		SFM_INLINE void update(float cutoff, float q = 0.5f, SvfLinearTrapOptimised2::FLT_TYPE type = LOW_PASS_FILTER, unsigned sampleRate = 44100) {
 			if (type != NO_FLT_TYPE)
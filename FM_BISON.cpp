@@ -10,15 +10,23 @@
 	#define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#include <chrono>
+#include <mutex>
+
 #include "FM_BISON.h"
 
 #include "synth-global.h"
 #include "patch/synth-patch-global.h"
 #include "synth-DX7-LFO-table.h"
+#include "synth-voice-lanes.h"
 
 namespace SFM
 {
-	static bool s_performStaticInit = true;
+	// Tables (& random generator) are global, so they're shared by all instances and initialized once (see Bison())
+	static std::once_flag s_staticInit;
+
+	// Initial guess of time (nanoseconds) a voice cost unit takes to render (see EstimateVoiceCost()), calibrated while rendering
+	constexpr float kDefTimePerCostUnit = 5.f;
 
 	/* ----------------------------------------------------------------------------------------------------
 
@@ -26,25 +34,35 @@ namespace SFM
 
 	 ------------------------------------------------------------------------------------------------------ */
 	
-	Bison::Bison()
+	Bison::Bison(unsigned numVoiceThreads /* = kAutoNumWorkers */)
 	{
-		if (true == s_performStaticInit)
+		// Instances may be created on different threads at once
+		std::call_once(s_staticInit, []
 		{
 			// Calculate LUTs & initialize random generator
 			InitializeRandomGenerator();
 			CalculateMIDIToFrequencyLUT();
 			InitializeFastCosine();
 			Supersaw::CalculateDetuneTable();
-
-			s_performStaticInit = false;
-		}
+			InitializeWavetables();
+		});
 		
-		// Reset entire patch
-		m_patch.ResetToEngineDefaults();
+		// Reset entire patch & make it current
+		m_editPatch.ResetToEngineDefaults();
+		PublishPatch();
+		UpdatePatch();
 
 		// Initialize polyphony
-		const bool monophonic = Patch::VoiceMode::kMono == m_patch.voiceMode;
-		m_curPolyphony = (false == monophonic) ? m_patch.maxPolyVoices : 1;
+		const bool monophonic = Patch::VoiceMode::kMono == m_pPatch->voiceMode;
+		m_curPolyphony = (false == monophonic) ? m_pPatch->maxPolyVoices : 1;
+
+#if !defined(SFM_DISABLE_VOICE_THREAD)
+		// Start voice render workers (they'll sleep until they're needed)
+		if (0 != numVoiceThreads)
+			m_threadPool = new ThreadPool(numVoiceThreads);
+#else
+		(void) numVoiceThreads;
+#endif
 
 		Log("Instance of FM. BISON engine initalized");
 		Log("Suzie, call DR. BISON, tell him it's for me...");
@@ -58,6 +76,9 @@ namespace SFM
 	{
 		DeleteRateDependentObjects();
 
+		delete m_threadPool;
+		m_threadPool = nullptr;
+
 		Log("Instance of FM. BISON engine released");
 	}
 
@@ -71,13 +92,16 @@ namespace SFM
 	// Called by JUCE's prepareToPlay()
 	void Bison::OnSetSamplingProperties(unsigned sampleRate, unsigned samplesPerBlock)
 	{
-		Log("BISON::OnSetSamplingProperties(" + std::to_string(sampleRate) + ", " + std::to_string(samplesPerBlock) + ")");
+		Log("BISON::OnSetSamplingProperties(%u, %u)", sampleRate, samplesPerBlock);
 
 		m_sampleRate       = sampleRate;
 		m_samplesPerBlock  = samplesPerBlock;
 
 		m_Nyquist = sampleRate>>1;
 
+		// Use latest patch
+		UpdatePatch();
+
 		/* 
 			Reset sample rate dependent global objects
 		*/
@@ -94,6 +118,16 @@ namespace SFM
 		m_polyVoiceReq.clear();
 		m_polyVoiceReleaseReq.clear();
 
+		// Forget about scheduled events
+		m_schedule.clear();
+		m_sustainChanged = false;
+
+		// Awake
+		m_numSilentBlocks = 0;
+		m_isAsleep = false;
+		m_isWaking = false;
+		m_numSleptSamples = 0;
+
 		m_resetVoices = false;
 		 
 		// Reset BPM
@@ -101,7 +135,7 @@ namespace SFM
 		m_resetPhaseBPM = true;
 
 		// Voice mode
-		m_curVoiceMode = m_patch.voiceMode;
+		m_curVoiceMode = m_pPatch->voiceMode;
 
 		// Reset monophonic state
 		m_monoSequence.clear();
@@ -112,24 +146,46 @@ namespace SFM
 		m_curFilterType = SvfLinearTrapOptimised2::NO_FLT_TYPE;
 
 		// Allocate intermediate buffers (a pair for each thread)
-		m_pBufL[0] = reinterpret_cast<float *>(mallocAligned(m_samplesPerBlock*sizeof(float), 16));
-		m_pBufL[1] = reinterpret_cast<float *>(mallocAligned(m_samplesPerBlock*sizeof(float), 16));
-		m_pBufR[0] = reinterpret_cast<float *>(mallocAligned(m_samplesPerBlock*sizeof(float), 16));
-		m_pBufR[1] = reinterpret_cast<float *>(mallocAligned(m_samplesPerBlock*sizeof(float), 16));
+		const unsigned numThreads = (nullptr != m_threadPool) ? m_threadPool->GetNumThreads() : 1;
+		for (unsigned iThread = 0; iThread < numThreads; ++iThread)
+		{
+			m_pBufL[iThread] = reinterpret_cast<float *>(mallocAligned(m_samplesPerBlock*sizeof(float), 16));
+			m_pBufR[iThread] = reinterpret_cast<float *>(mallocAligned(m_samplesPerBlock*sizeof(float), 16));
+		}
+
+		// Allocate modulation bus (each buffer 16-byte aligned)
+		const unsigned busStride = (m_samplesPerBlock+3) & ~3;
+		m_pModBusBuf = reinterpret_cast<float *>(mallocAligned(kNumModulationBusBuffers*busStride*sizeof(float), 16));
+
+		float *pBusBuf = m_pModBusBuf;
+		for (float **ppBuf : { &m_modBus.pAftertouch, &m_modBus.pModulation, &m_modBus.pPitchBend, &m_modBus.pAmpBend, &m_modBus.pLFOBlend, &m_modBus.pLFOModDepth, &m_modBus.pCutoff, &m_modBus.pQ })
+		{
+			*ppBuf = pBusBuf;
+			pBusBuf += busStride;
+		}
+
+		for (float *&pPitchBendMul : m_modBus.pPitchBendMul)
+		{
+			pPitchBendMul = pBusBuf;
+			pBusBuf += busStride;
+		}
+
+		SFM_ASSERT(pBusBuf == m_pModBusBuf + kNumModulationBusBuffers*busStride);
 
 		// Create effects
-		m_postPass = new PostPass(m_sampleRate, m_samplesPerBlock, m_Nyquist);
+		m_postPass = new PostPass(m_sampleRate, m_samplesPerBlock, m_Nyquist, m_postOversamplingStages, m_postOversamplingDesign);
 
 		// Start global LFO phase
 		m_globalLFO = new Phase(m_sampleRate);
-		const float freqLFO = MIDI_To_DX7_LFO_Hz(m_patch.LFORate);
+		const float freqLFO = MIDI_To_DX7_LFO_Hz(m_pPatch->LFORate);
 		m_globalLFO->Initialize(freqLFO, m_sampleRate);
+		m_globalLFOClock = m_sampleClock;
 
 		// Reset global interpolated parameters
-		m_curLFOBlend    = { m_patch.LFOBlend, m_sampleRate, kDefParameterLatency, 0.f, 1.f };
-		m_curLFOModDepth = { m_patch.LFOModDepth, m_sampleRate, kDefParameterLatency, 0.f, 1.f };
-		m_curCutoff      = { SVF_CutoffToHz(m_patch.cutoff, m_Nyquist), m_sampleRate, kDefParameterLatency * 10.f /* Longer */, kSVFMinFilterCutoffHz, kSVFMaxFilterCutoffHz};
-		m_curQ           = { SVF_ResoToQ(m_patch.resonance), m_sampleRate, kDefParameterLatency, kSVFMinFilterQ, kSVFMaxFilterQ};
+		m_curLFOBlend    = { m_pPatch->LFOBlend, m_sampleRate, kDefParameterLatency, 0.f, 1.f };
+		m_curLFOModDepth = { m_pPatch->LFOModDepth, m_sampleRate, kDefParameterLatency, 0.f, 1.f };
+		m_curCutoff      = { SVF_CutoffToHz(m_pPatch->cutoff, m_Nyquist), m_sampleRate, kDefParameterLatency * 10.f /* Longer */, kSVFMinFilterCutoffHz, kSVFMaxFilterCutoffHz};
+		m_curQ           = { SVF_ResoToQ(m_pPatch->resonance), m_sampleRate, kDefParameterLatency, kSVFMinFilterQ, kSVFMaxFilterQ};
 		m_curPitchBend   = { 0.f, m_sampleRate, kDefParameterLatency, -1.f, 1.f };
 		m_curAmpBend     = { 1.f /* 0dB */, m_sampleRate, kDefParameterLatency, 0.f, 1.f };
 		m_curModulation  = { 0.f, m_sampleRate, kDefParameterLatency * 1.5f /* Longer */, 0.f, 1.f };
@@ -138,21 +194,32 @@ namespace SFM
 		// Reset operator peaks (visualization)
 		for (float &peak : m_opPeaks)
 			peak = 0.f;
+
+		// Reset voice render costs
+		for (auto &cost : m_voiceCosts)
+			cost = { 0.f, 0.f, 0.f, 0 };
+
+		m_timePerCostUnit = kDefTimePerCostUnit;
 	}
 
 	// Cleans up after OnSetSamplingProperties()
 	void Bison::DeleteRateDependentObjects()
 	{
-		// Allocate intermediate sample buffers
-		if (nullptr != m_pBufL[0]) // Good enough to assume
+		// Release intermediate sample buffers
+		for (unsigned iThread = 0; iThread < kMaxPoolThreads; ++iThread)
 		{
-			freeAligned(m_pBufL[0]);
-			freeAligned(m_pBufL[1]);
-			freeAligned(m_pBufR[0]);
-			freeAligned(m_pBufR[1]);
+			if (nullptr != m_pBufL[iThread]) // Good enough to assume
+			{
+				freeAligned(m_pBufL[iThread]);
+				freeAligned(m_pBufR[iThread]);
+			}
+
+			m_pBufL[iThread] = m_pBufR[iThread] = nullptr;
 		}
 
-		m_pBufL[0] = m_pBufL[1] = m_pBufR[0] = m_pBufR[1] = nullptr;
+		// Release modulation bus
+		freeAligned(m_pModBusBuf);
+		m_pModBusBuf = nullptr;
 
 		// Release post-pass
 		delete m_postPass;
@@ -190,7 +257,7 @@ namespace SFM
 		voice.OnRelease();
 
 		const int key = voice.m_key;
-		Log("Voice released: " + std::to_string(index) + " for key: " + std::to_string(key));
+		Log("Voice released: %d for key: %d", index, key);
 	}
 	
 	// Free voice & key slot immediately
@@ -206,6 +273,10 @@ namespace SFM
 		voice.m_state = Voice::kIdle;
 		voice.m_sustained = false;
 
+		// Supersaws are free running from here on
+		for (auto &voiceOp : voice.m_operators)
+			voiceOp.oscillator.GetSupersaw().Free(m_sampleClock);
+
 		// Decrease global count
 		SFM_ASSERT(m_voiceCount > 0);
 		--m_voiceCount;
@@ -217,10 +288,10 @@ namespace SFM
 			FreeKey(voice.m_key);
 			voice.m_key = -1;
 
-			Log("Voice freed: " + std::to_string(index) + " for key: " + std::to_string(key));
+			Log("Voice freed: %d for key: %d", index, key);
 		}
 		else
-			Log("Voice freed: " + std::to_string(index));
+			Log("Voice freed: %d", index);
 	}
 
 	// Steal voice (quick fade)
@@ -254,15 +325,30 @@ namespace SFM
 			FreeKey(key);
 			voice.m_key = -1;
 
-			Log("Voice stolen: " + std::to_string(index) + " for key: " + std::to_string(key));
+			Log("Voice stolen: %d for key: %d", index, key);
 		}
 		else
-			Log("Voice stolen (not bound to key): " + std::to_string(index));
+			Log("Voice stolen (not bound to key): %d", index);
 	}
 
 	void Bison::NoteOn(unsigned key, float frequency, float velocity, unsigned timeStamp)
 	{
-		const bool monophonic = Patch::VoiceMode::kMono == m_patch.voiceMode;
+		SFM_ASSERT(key <= 127);
+		SFM_ASSERT(velocity >= 0.f && velocity <= 1.f);
+
+		ScheduleEvent({ Event::kNoteOn, timeStamp, key, frequency, velocity, false });
+	}
+
+	void Bison::NoteOff(unsigned key, unsigned timeStamp)
+	{
+		SFM_ASSERT(key <= 127);
+
+		ScheduleEvent({ Event::kNoteOff, timeStamp, key, 0.f, 0.f, false });
+	}
+
+	void Bison::OnNoteOn(unsigned key, float frequency, float velocity, unsigned timeStamp)
+	{
+		const bool monophonic = Patch::VoiceMode::kMono == m_pPatch->voiceMode;
 
 		SFM_ASSERT(key <= 127);
 		SFM_ASSERT(velocity >= 0.f && velocity <= 1.f);
@@ -271,7 +357,7 @@ namespace SFM
 		for (const auto &request : m_polyVoiceReq)
 			if (request.key == key)
 			{
-				Log("Duplicate NoteOn() for key: " + std::to_string(key));
+				Log("Duplicate NoteOn() for key: %u", key);
 				return;
 			}
 
@@ -300,7 +386,7 @@ namespace SFM
 					if (false == voice.IsStolen())
 						StealVoice(index);
 
-					Log("NoteOn() retrigger: " + std::to_string(key) + ", voice: " + std::to_string(index));
+					Log("NoteOn() retrigger: %u, voice: %d", key, index);
 				}
 			}
 
@@ -322,7 +408,7 @@ namespace SFM
 
 			SFM_ASSERT(1 == m_curPolyphony);
 
-			Log("NoteOn() monophonic, key: " + std::to_string(key));
+			Log("NoteOn() monophonic, key: %u", key);
 
 			if (false == m_monoVoiceReq.MonoIsValid() || request.timeStamp <= m_monoVoiceReq.timeStamp)
 			{
@@ -331,14 +417,17 @@ namespace SFM
 				Log("Monophonic: is audible request");
 			}
 
-			// Always add requests to sequence
+			// Always add requests to sequence (if it's full, which takes quite the pianist, forget the oldest one)
+			if (true == m_monoSequence.full())
+				m_monoSequence.pop_back();
+
 			m_monoSequence.emplace_front(request);
 		}
 	}
 
-	void Bison::NoteOff(unsigned key, unsigned timeStamp)
+	void Bison::OnNoteOff(unsigned key, unsigned timeStamp)
 	{
-		const bool monophonic = Patch::VoiceMode::kMono == m_patch.voiceMode;
+		const bool monophonic = Patch::VoiceMode::kMono == m_pPatch->voiceMode;
 
 		SFM_ASSERT(key <= 127);
 
@@ -346,7 +435,7 @@ namespace SFM
 		for (auto request : m_polyVoiceReleaseReq)
 			if (request == key)
 			{
-				Log("Duplicate NoteOff() for key: " + std::to_string(key));
+				Log("Duplicate NoteOff() for key: %u", key);
 				return;
 			}
 
@@ -369,7 +458,7 @@ namespace SFM
 					// Erase and break since NoteOn() ensures there are no duplicates in the deque
 					m_polyVoiceReq.erase(iReq);
 
-					Log("Deferred NoteOn() removed due to matching NOTE_OFF for key: " + std::to_string(key));
+					Log("Deferred NoteOn() removed due to matching NOTE_OFF for key: %u", key);
 
 					break;
 				}
@@ -379,7 +468,7 @@ namespace SFM
 		{
 			/* Monophonic */
 
-			Log("NoteOff() monophonic, key: " + std::to_string(key));
+			Log("NoteOff() monophonic, key: %u", key);
 
 			const int index = GetVoice(key);
 			if (index >= 0)
@@ -411,6 +500,182 @@ namespace SFM
 		}
 	}
 
+	/* ----------------------------------------------------------------------------------------------------
+
+		Patch snapshots
+
+		The writer copies its patch into a snapshot & publishes it through a triple buffer, so Render() 
+		always has a complete (and the latest) patch without waiting, locking or copying it itself.
+
+		Each snapshot carries a generation per section, bumped when that section differs from the previously
+		published one, so Render() can skip work for sections that didn't change (see UpdateVoicesPreRender()).
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	void Bison::PublishPatch()
+	{
+		static_assert(0 == offsetof(Patch, operators), "Patch::operators must come first (see kPatchGlobals)");
+
+		const Patch &patch = m_editPatch;
+		PatchSnapshot &published = m_published;
+
+		// Padding may differ too, which at worst counts as a change
+		const char *pNew = reinterpret_cast<const char *>(&patch);
+		const char *pOld = reinterpret_cast<const char *>(&published.patch);
+		const bool neverPublished = 0 == published.generation[kPatchOperators];
+
+		if (true == neverPublished || 0 != memcmp(pNew, pOld, sizeof(PatchOperators)))
+			++published.generation[kPatchOperators];
+
+		if (true == neverPublished || 0 != memcmp(pNew + sizeof(PatchOperators), pOld + sizeof(PatchOperators), sizeof(Patch)-sizeof(PatchOperators)))
+			++published.generation[kPatchGlobals];
+
+		published.patch = patch;
+
+		m_patches.GetWriteBuffer() = published;
+		m_patches.Publish();
+	}
+
+	void Bison::UpdatePatch()
+	{
+		if (true == m_patches.Update())
+		{
+			const PatchSnapshot &snapshot = m_patches.Read();
+
+			m_pPatch = &snapshot.patch;
+
+			for (unsigned iSection = 0; iSection < kNumPatchSections; ++iSection)
+				m_patchGen[iSection] = snapshot.generation[iSection];
+		}
+
+		SFM_ASSERT(nullptr != m_pPatch);
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Events
+
+		All note, sustain & controller events are scheduled by time stamp and handled by Render(), which
+		splits the block where necessary (see RenderScheduled()), so they take effect at the right sample
+
+		Post*() may be called from (one) thread other than the render thread; these events are queued in a
+		wait-free SPSC ring buffer and moved to the schedule at the start of each Render() call, so the 
+		producer never waits on the render thread (nor vice versa)
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	bool Bison::PostNoteOn(unsigned key, float frequency, float velocity, unsigned timeStamp)
+	{
+		SFM_ASSERT(key <= 127);
+		SFM_ASSERT_NORM(velocity);
+		return PostEvent(Event::kNoteOn, timeStamp, key, frequency, velocity, false);
+	}
+
+	bool Bison::PostNoteOff(unsigned key, unsigned timeStamp)
+	{
+		SFM_ASSERT(key <= 127);
+		return PostEvent(Event::kNoteOff, timeStamp, key, 0.f, 0.f, false);
+	}
+
+	bool Bison::PostSustain(bool state, unsigned timeStamp)
+	{
+		return PostEvent(Event::kSustain, timeStamp, 0, 0.f, 0.f, state);
+	}
+
+	bool Bison::PostPitchBend(float bendWheel, unsigned timeStamp)
+	{
+		SFM_ASSERT_BINORM(bendWheel);
+		return PostEvent(Event::kPitchBend, timeStamp, 0, bendWheel, 0.f, false);
+	}
+
+	bool Bison::PostModulation(float modulation, unsigned timeStamp)
+	{
+		SFM_ASSERT_NORM(modulation);
+		return PostEvent(Event::kModulation, timeStamp, 0, modulation, 0.f, false);
+	}
+
+	bool Bison::PostAftertouch(float aftertouch, unsigned timeStamp)
+	{
+		SFM_ASSERT_NORM(aftertouch);
+		return PostEvent(Event::kAftertouch, timeStamp, 0, aftertouch, 0.f, false);
+	}
+
+	bool Bison::PostBPM(float BPM, bool resetPhase)
+	{
+		return PostEvent(Event::kBPM, 0, 0, BPM, 0.f, resetPhase);
+	}
+
+	void Bison::ScheduleEvent(const Event &event)
+	{
+		if (true == m_schedule.full())
+		{
+			// Should not happen with sane input (kMaxEvents per block)
+			Log("Event schedule full, event dropped");
+			return;
+		}
+
+		// Insert after last event with the same (or an earlier) time stamp
+		auto iEvent = m_schedule.end();
+		while (iEvent != m_schedule.begin() && (iEvent-1)->timeStamp > event.timeStamp)
+			--iEvent;
+
+		m_schedule.insert(iEvent, event);
+	}
+
+	void Bison::DrainEvents()
+	{
+		Event event;
+		while (false == m_schedule.full() && true == m_events.Pop(event))
+			ScheduleEvent(event);
+	}
+
+	// Handles event at 'offset' samples into current block (render thread only)
+	void Bison::ApplyEvent(const Event &event, unsigned offset)
+	{
+		SFM_ASSERT(event.timeStamp >= offset);
+
+		switch (event.type)
+		{
+		case Event::kNoteOn:
+			// Voice starts at exact time stamp (see Voice::m_sampleOffs)
+			OnNoteOn(event.key, event.value, event.velocity, event.timeStamp-offset);
+			break;
+
+		case Event::kNoteOff:
+			OnNoteOff(event.key, event.timeStamp-offset);
+			break;
+
+		case Event::kSustain:
+			if (m_sustain != event.state)
+			{
+				m_sustain = event.state;
+				m_sustainChanged = true;
+			}
+
+			break;
+
+		case Event::kPitchBend:
+			m_eventBendWheel = event.value;
+			break;
+
+		case Event::kModulation:
+			m_eventModulation = event.value;
+			break;
+
+		case Event::kAftertouch:
+			m_eventAftertouch = event.value;
+			break;
+
+		case Event::kBPM:
+			SetBPM(event.value, event.state);
+			break;
+
+		default:
+			SFM_ASSERT(false);
+			break;
+		}
+	}
+
 	/* ----------------------------------------------------------------------------------------------------
 
 		Voice initialization helper functions
@@ -685,7 +950,9 @@ namespace SFM
 	void Bison::InitializeLFOs(Voice &voice, float jitter)
 	{
 		// Calc. shift
-		float phaseShift = (true == m_patch.LFOKeySync)
+		CatchUpGlobalLFO();
+
+		float phaseShift = (true == m_pPatch->LFOKeySync)
 			? 0.f // Synchronized 
 			: m_globalLFO->Get(); // Free running
 
@@ -694,12 +961,12 @@ namespace SFM
 		
 		// Frequencies
 		float frequency = m_globalLFO->GetFrequency(), modFrequency;
-		CalcLFOFreq(frequency, modFrequency, m_patch.LFOModSpeed);
+		CalcLFOFreq(frequency, modFrequency, m_pPatch->LFOModSpeed);
 
 		// Set up LFOs
-		voice.m_LFO1.Initialize(m_patch.LFOWaveform1,   frequency,    m_sampleRate, phaseShift);
-		voice.m_LFO2.Initialize(m_patch.LFOWaveform2,   frequency,    m_sampleRate, phaseShift);
-		voice.m_modLFO.Initialize(m_patch.LFOWaveform3, modFrequency, m_sampleRate, phaseShift);
+		voice.m_LFO1.Initialize(m_pPatch->LFOWaveform1,   frequency,    m_sampleRate, phaseShift);
+		voice.m_LFO2.Initialize(m_pPatch->LFOWaveform2,   frequency,    m_sampleRate, phaseShift);
+		voice.m_modLFO.Initialize(m_pPatch->LFOWaveform3, modFrequency, m_sampleRate, phaseShift);
 	}
 
 	/* ----------------------------------------------------------------------------------------------------
@@ -723,8 +990,11 @@ namespace SFM
 		SFM_ASSERT(request.timeStamp <= m_samplesPerBlock);
 		voice.m_sampleOffs = request.timeStamp;
 
+		// Previous measurement is of no use for a new note
+		m_voiceCosts[iVoice].timePerSample = 0.f;
+
 		const unsigned key = request.key;        // Key
-		const float jitter = m_patch.jitter;     // Jitter
+		const float jitter = m_pPatch->jitter;     // Jitter
 		const float velocity = request.velocity; // Velocity
 
 		// Store key & velocity immediately (used by CalcOpLevel())
@@ -741,12 +1011,15 @@ namespace SFM
 		fundamentalFreq *= powf(2.f, (noteJitter*0.01f)/12.f);
 
 		voice.m_fundamentalFreq = fundamentalFreq;
+
+		// Set real-time parameters on next update
+		voice.m_opPatchGen = 0;
 		
 		// Initialize LFO
 		InitializeLFOs(voice, jitter);
 
 		// Get dry FM patch		
-		PatchOperators &patchOps = m_patch.operators;
+		const PatchOperators &patchOps = m_pPatch->operators;
 
 		// Default glide (in case frequency is manipulated whilst playing)
 		voice.m_freqGlide = kDefPolyFreqGlide;
@@ -754,7 +1027,7 @@ namespace SFM
 		// Acoustic scaling: more velocity can mean longer envelope decay phase
 		// This is specifically designed for piano, guitar et cetera: strum or strike
 		// harder and the decay phase will be longer
-		const float envAcousticScaling = 1.f + (velocity*velocity)*m_patch.acousticScaling;
+		const float envAcousticScaling = 1.f + (velocity*velocity)*m_pPatch->acousticScaling;
 
 		// Set up voice operators
 		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
@@ -767,6 +1040,9 @@ namespace SFM
 
 			voiceOp.envGain.Reset();
 
+			// Catch up on free running supersaw phases (if not in use they keep running)
+			ResumeSupersaw(voiceOp);
+
 			if (true == voiceOp.enabled)
 			{
 				// Operator velocity
@@ -785,7 +1061,7 @@ namespace SFM
 				const float amplitude = patchOp.output*level, index = patchOp.index*level;
 
 				voiceOp.oscillator.Initialize(
-					patchOp.waveform, frequency, m_sampleRate, CalcPhaseShift(voiceOp, patchOp), patchOp.supersawDetune, patchOp.supersawMix);
+					patchOp.waveform, frequency, m_sampleRate, CalcPhaseShift(voiceOp, patchOp), patchOp.supersawDetune, patchOp.supersawMix, m_operatorEngine);
 
 				// Set supersaw parameters for interpolation
 				voiceOp.supersawDetune.SetRate(m_sampleRate, kDefParameterLatency);
@@ -837,14 +1113,14 @@ namespace SFM
 		}
 
 		// Reset main filter
-		voice.m_filterSVF.resetState();
+		voice.m_filterSVF.Reset();
 
 		// Start filter envelope
-		voice.m_filterEnvelope.Start(m_patch.filterEnvParams, m_sampleRate, false, 1.f, envAcousticScaling);
+		voice.m_filterEnvelope.Start(m_pPatch->filterEnvParams, m_sampleRate, false, 1.f, envAcousticScaling);
 
 		// Start pitch envelope
-		voice.m_pitchBendRange = m_patch.pitchBendRange;
-		voice.m_pitchEnvelope.Start(m_patch.pitchEnvParams, m_sampleRate);
+		voice.m_pitchBendRange = m_pPatch->pitchBendRange;
+		voice.m_pitchEnvelope.Start(m_pPatch->pitchEnvParams, m_sampleRate);
 
 		// Voice is now playing
 		voice.m_state = Voice::kPlaying;
@@ -874,7 +1150,7 @@ namespace SFM
 		voice.m_sustained = false;
 
 		const unsigned key = request.key;    // Key
-		const float jitter = m_patch.jitter; // Jitter
+		const float jitter = m_pPatch->jitter; // Jitter
 
 		const float velocity = request.velocity;
 
@@ -892,6 +1168,9 @@ namespace SFM
 		fundamentalFreq *= powf(2.f, (noteJitter*kMaxNoteJitter*0.01f)/12.f);
 
 		voice.m_fundamentalFreq = fundamentalFreq;
+
+		// Set real-time parameters on next update
+		voice.m_opPatchGen = 0;
 		
 		if (true == reset)
 		{
@@ -900,14 +1179,14 @@ namespace SFM
 		}
 
 		// See InitializeVoice()
-		const float envAcousticScaling = 1.f + (velocity*velocity)*m_patch.acousticScaling;
+		const float envAcousticScaling = 1.f + (velocity*velocity)*m_pPatch->acousticScaling;
 
 		// Get patch operators		
-		PatchOperators &patchOps = m_patch.operators;
+		const PatchOperators &patchOps = m_pPatch->operators;
 
 		// Calc. attenuated glide (using new velocity, feels more natural)
-		float monoGlide = m_patch.monoGlide;
-		float glideAtt = 1.f - m_patch.monoAtt*request.velocity;
+		float monoGlide = m_pPatch->monoGlide;
+		float glideAtt = 1.f - m_pPatch->monoAtt*request.velocity;
 		voice.m_freqGlide = monoGlide*glideAtt;
 
 		// Set up voice operators
@@ -921,6 +1200,9 @@ namespace SFM
 
 			voiceOp.envGain.Reset();
 
+			// Catch up on free running supersaw phases (if not in use they keep running)
+			ResumeSupersaw(voiceOp);
+
 			if (true == voiceOp.enabled)
 			{
 				// Operator velocity
@@ -944,7 +1226,7 @@ namespace SFM
 				if (true == reset)
 				{
 					voiceOp.oscillator.Initialize(
-						patchOp.waveform, frequency, m_sampleRate, CalcPhaseShift(voiceOp, patchOp), patchOp.supersawDetune, patchOp.supersawMix);
+						patchOp.waveform, frequency, m_sampleRate, CalcPhaseShift(voiceOp, patchOp), patchOp.supersawDetune, patchOp.supersawMix, m_operatorEngine);
 
 					// Set supersaw parameters for interpolation
 					voiceOp.supersawDetune.SetRate(m_sampleRate, kDefParameterLatency);
@@ -1012,14 +1294,14 @@ namespace SFM
 		if (true == reset)
 		{
 			// Reset main filter
-			voice.m_filterSVF.resetState();
+			voice.m_filterSVF.Reset();
 			
 			// Start filter envelope
-			voice.m_filterEnvelope.Start(m_patch.filterEnvParams, m_sampleRate, false, 1.f, envAcousticScaling);
+			voice.m_filterEnvelope.Start(m_pPatch->filterEnvParams, m_sampleRate, false, 1.f, envAcousticScaling);
 
 			// Start pitch envelope
-			voice.m_pitchBendRange = m_patch.pitchBendRange;
-			voice.m_pitchEnvelope.Start(m_patch.pitchEnvParams, m_sampleRate);
+			voice.m_pitchBendRange = m_pPatch->pitchBendRange;
+			voice.m_pitchEnvelope.Start(m_pPatch->pitchEnvParams, m_sampleRate);
 		}
 
 		// Voice is now playing
@@ -1043,7 +1325,7 @@ namespace SFM
 	// Prepare voices for Render() pass
 	void Bison::UpdateVoicesPreRender()
 	{
-		m_modeSwitch = m_curVoiceMode != m_patch.voiceMode;
+		m_modeSwitch = m_curVoiceMode != m_pPatch->voiceMode;
 		const bool monophonic = Patch::VoiceMode::kMono == m_curVoiceMode;
 
 		/*
@@ -1067,7 +1349,7 @@ namespace SFM
 				{
 					StealVoice(iVoice);
 
-					Log("Voice mode switch / Voice reset, stealing voice: " + std::to_string(iVoice));
+					Log("Voice mode switch / Voice reset, stealing voice: %u", iVoice);
 				}
 			}
 
@@ -1075,7 +1357,7 @@ namespace SFM
 			m_polyVoiceReleaseReq.clear();
 
 			// Set voice mode state
-			m_curVoiceMode = m_patch.voiceMode;
+			m_curVoiceMode = m_pPatch->voiceMode;
 
 			// Monophonic?
 			if (true == monophonic)
@@ -1101,7 +1383,8 @@ namespace SFM
 		{
 			/* Polyphonic */
 
-			std::deque<VoiceReleaseRequest> remainder;
+			// Deferred requests are kept (in place)
+			unsigned numRemaining = 0;
 		
 			for (auto key : m_polyVoiceReleaseReq)
 			{
@@ -1124,12 +1407,13 @@ namespace SFM
 					else
 					{
 						// Voice is sustained, defer request
-						remainder.emplace_back(key);
+						m_polyVoiceReleaseReq[numRemaining++] = key;
 					}
 				}
 			}
 
-			m_polyVoiceReleaseReq = remainder;
+			while (m_polyVoiceReleaseReq.size() > numRemaining)
+				m_polyVoiceReleaseReq.pop_back();
 		}
 
 		/*
@@ -1164,7 +1448,7 @@ namespace SFM
 			// If we still have requests, try to steal (releasing or sustaining) voices in order to 
 			// free up slots that can be used to spawn these voices the next frame (no gaurantee though!)
 
-			size_t remainingRequests = m_polyVoiceReq.size();
+			unsigned remainingRequests = m_polyVoiceReq.size();
 
 			if (remainingRequests > 0)
 			{
@@ -1174,7 +1458,7 @@ namespace SFM
 					float summedOutput;
 				};
 
-				std::vector<VoiceRef> voiceRefs;
+				FixedVector<VoiceRef, kMaxPolyVoices> voiceRefs;
 
 				for (unsigned iVoice = 0; iVoice < m_curPolyphony; ++iVoice)
 				{
@@ -1205,7 +1489,7 @@ namespace SFM
 					// Steal voice
 					const unsigned iVoice = voiceRef.iVoice;
 					StealVoice(iVoice);
-					Log("Voice stolen (index): " + std::to_string(iVoice));
+					Log("Voice stolen (index): %u", iVoice);
 					
 					if (--remainingRequests == 0)
 						break;
@@ -1214,7 +1498,7 @@ namespace SFM
 				if (remainingRequests != 0)
 				{
 					// FIXME: I think it's a viable strategy to drop the remaining requests?
-					Log("Could not steal enough voices: " + std::to_string(remainingRequests) + " remaining.");
+					Log("Could not steal enough voices: %u remaining.", remainingRequests);
 				}
 			}
 
@@ -1253,7 +1537,7 @@ namespace SFM
 
 						fromSequence = true;
 
-						Log("Monophonic: trigger previous note in sequence: " + std::to_string(m_monoVoiceReq.key));
+						Log("Monophonic: trigger previous note in sequence: %u", m_monoVoiceReq.key);
 					}
 				}
 				else
@@ -1348,54 +1632,60 @@ namespace SFM
 						// FIXME: I could do this for all voices that satisfy the condition above (and just retain the last known amplitude, issue created 16/09/2020)
 						if (-1 != voice.m_key)
 						{
-							// Update active voice:
-							// - Each (active) operator has a set of parameters that need per-sample interpolation 
-							// - Most of these are updated in this loop
-							// - The set of parameters (also outside of this object) isn't conclusive and may vary depending on the use of FM. BISON (currently: VST plug-in)
-
-							for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+							// Skip if the parameters have been set since the operators last changed
+							if (m_patchGen[kPatchOperators] != voice.m_opPatchGen)
 							{
-								auto &voiceOp = voice.m_operators[iOp];
+								// Update active voice:
+								// - Each (active) operator has a set of parameters that need per-sample interpolation 
+								// - Most of these are updated in this loop
+								// - The set of parameters (also outside of this object) isn't conclusive and may vary depending on the use of FM. BISON (currently: VST plug-in)
 
-								// Update per-sample interpolated parameters
-								if (true == voiceOp.enabled)
+								for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
 								{
-									const float fundamentalFreq = voice.m_fundamentalFreq;
-									const PatchOperators::Operator &patchOp = m_patch.operators.operators[iOp];
+									auto &voiceOp = voice.m_operators[iOp];
 
-									// Get velocity & frequency
-									const float opVelocity = (false == patchOp.velocityInvert) ? voice.m_velocity : 1.f-voice.m_velocity;
-									const float frequency = CalcOpFreq(fundamentalFreq, voiceOp.detuneOffs, patchOp);
-
-									// Get amplitude & index
-									const float level = CalcOpLevel(voice.m_key, opVelocity, patchOp);
-									const float amplitude = patchOp.output*level, index = patchOp.index*level;
-								
-									// Interpolate freq. if necessary
-									if (frequency != voiceOp.setFrequency)
+									// Update per-sample interpolated parameters
+									if (true == voiceOp.enabled)
 									{
-										voiceOp.curFreq.SetTarget(frequency);
-										voiceOp.setFrequency = frequency;
-									}
-
-									// Set amplitude & index
-									voiceOp.amplitude.SetTarget(amplitude);
-									voiceOp.index.SetTarget(index);
+										const float fundamentalFreq = voice.m_fundamentalFreq;
+										const PatchOperators::Operator &patchOp = m_pPatch->operators.operators[iOp];
 
-									// Square(pusher) (or "drive")
-									const float softClip = CalcSoftClip(opVelocity, patchOp);
-									voiceOp.softClip.SetTarget(softClip);
+										// Get velocity & frequency
+										const float opVelocity = (false == patchOp.velocityInvert) ? voice.m_velocity : 1.f-voice.m_velocity;
+										const float frequency = CalcOpFreq(fundamentalFreq, voiceOp.detuneOffs, patchOp);
 
-									// Feedback amount
-									voiceOp.feedbackAmt.SetTarget(patchOp.feedbackAmt);
+										// Get amplitude & index
+										const float level = CalcOpLevel(voice.m_key, opVelocity, patchOp);
+										const float amplitude = patchOp.output*level, index = patchOp.index*level;
+								
+										// Interpolate freq. if necessary
+										if (frequency != voiceOp.setFrequency)
+										{
+											voiceOp.curFreq.SetTarget(frequency);
+											voiceOp.setFrequency = frequency;
+										}
+
+										// Set amplitude & index
+										voiceOp.amplitude.SetTarget(amplitude);
+										voiceOp.index.SetTarget(index);
+
+										// Square(pusher) (or "drive")
+										const float softClip = CalcSoftClip(opVelocity, patchOp);
+										voiceOp.softClip.SetTarget(softClip);
+
+										// Feedback amount
+										voiceOp.feedbackAmt.SetTarget(patchOp.feedbackAmt);
 					
-									// Panning (as set by static parameter)
-									voiceOp.panning.SetTarget(CalcPanning(patchOp));
+										// Panning (as set by static parameter)
+										voiceOp.panning.SetTarget(CalcPanning(patchOp));
 
-									// Supersaw parameters
-									voiceOp.supersawDetune.SetTarget(patchOp.supersawDetune);
-									voiceOp.supersawMix.SetTarget(patchOp.supersawMix);
+										// Supersaw parameters
+										voiceOp.supersawDetune.SetTarget(patchOp.supersawDetune);
+										voiceOp.supersawMix.SetTarget(patchOp.supersawMix);
+									}
 								}
+
+								voice.m_opPatchGen = m_patchGen[kPatchOperators];
 							}
 						}
 						else
@@ -1440,7 +1730,7 @@ namespace SFM
 	// Update sustain state
 	void Bison::UpdateSustain()
 	{
-		if (Patch::kNoPedal == m_patch.sustainType || Patch::kWahPedal == m_patch.sustainType)
+		if (Patch::kNoPedal == m_pPatch->sustainType || Patch::kWahPedal == m_pPatch->sustainType)
 			return;
 
 		// Sustain of pitch envelope is taken care of in synth-voice.cpp!
@@ -1449,7 +1739,7 @@ namespace SFM
 
 		const bool monophonic = Patch::VoiceMode::kMono == m_curVoiceMode;
 
-		if (Patch::kSynthPedal == m_patch.sustainType || true == monophonic /* Monophonic *always* uses synthesizer style pedal mode */)
+		if (Patch::kSynthPedal == m_pPatch->sustainType || true == monophonic /* Monophonic *always* uses synthesizer style pedal mode */)
 		{
 			/*
 				Emulate the synthesizer type behaviour (like the DX7) which means that the envelope runs until it hits the sustain phase
@@ -1465,7 +1755,7 @@ namespace SFM
 					if (true == voice.IsPlaying() && false == voice.IsSustained())
 					{
 						voice.m_sustained = true;
-						Log("Voice sustained (synth.): " + std::to_string(iVoice));
+						Log("Voice sustained (synth.): %u", iVoice);
 					}
 				}
 			}
@@ -1478,19 +1768,19 @@ namespace SFM
 					if (true == voice.IsPlaying() && true == voice.IsSustained())
 					{
 						voice.m_sustained = false;
-						Log("Voice no longer sustained (synth.): " + std::to_string(iVoice));
+						Log("Voice no longer sustained (synth.): %u", iVoice);
 					}
 				}
 			}
 		}
-		else if (Patch::kPianoPedal == m_patch.sustainType)
+		else if (Patch::kPianoPedal == m_pPatch->sustainType)
 		{
 			/*
 				Emulation of piano (or CP) behaviour.
 			*/
 
-			const float pedalFalloff    = m_patch.pianoPedalFalloff;
-			const float pedalReleaseMul = m_patch.pianoPedalReleaseMul;
+			const float pedalFalloff    = m_pPatch->pianoPedalFalloff;
+			const float pedalReleaseMul = m_pPatch->pianoPedalReleaseMul;
 			
 			if (true == state)
 			{
@@ -1511,7 +1801,7 @@ namespace SFM
 								voiceOp.envelope.OnPianoSustain(pedalFalloff, pedalReleaseMul);
 							}
 
-						Log("Voice sustained (CP): " + std::to_string(iVoice));
+						Log("Voice sustained (CP): %u", iVoice);
 					}
 				}
 			}
@@ -1524,7 +1814,7 @@ namespace SFM
 					if (false == voice.IsIdle() && true == voice.IsSustained())
 					{
 						voice.m_sustained = false;
-						Log("Voice no longer sustained (CP): " + std::to_string(iVoice));
+						Log("Voice no longer sustained (CP): %u", iVoice);
 					}
 				}
 			}
@@ -1543,126 +1833,426 @@ namespace SFM
 
 	 ------------------------------------------------------------------------------------------------------ */
 
-	/* static */ void Bison::VoiceRenderThread(Bison *pInst, VoiceThreadContext *pContext)
+	// Relative cost per sample of an oscillator waveform (sine is 1)
+	static float GetWaveformCost(Oscillator::Waveform form)
+	{
+		switch (form)
+		{
+		case Oscillator::Waveform::kNone:
+			return 0.f;
+
+		case Oscillator::Waveform::kSine:
+		case Oscillator::Waveform::kCosine:
+		case Oscillator::Waveform::kUniRamp:
+		case Oscillator::Waveform::kRamp:
+		case Oscillator::Waveform::kSaw:
+		case Oscillator::Waveform::kSquare:
+		case Oscillator::Waveform::kTriangle:
+		case Oscillator::Waveform::kPulse:
+		case Oscillator::Waveform::kWhiteNoise:
+			return 1.f;
+
+		case Oscillator::Waveform::kPinkNoise:
+		case Oscillator::Waveform::kSampleAndHold:
+			return 2.f;
+
+		case Oscillator::Waveform::kSupersaw:
+			return 7.f; // 7 PolyBLEP saws, HPF & DC blocker
+
+		default:
+			return 1.5f; // PolyBLEP et cetera
+		}
+	}
+
+	// Estimated (relative) cost of rendering a single sample of a voice; it's only used to order voices
+	// and it's calibrated against actual measurements, so it needn't be exact
+	static float EstimateVoiceCost(const Voice &voice, bool hasMainFilter, unsigned filterControlRate)
+	{
+		float cost = 3.f; // LFOs, pitch envelope, bend
+
+		if (true == hasMainFilter)
+			cost += 1.f + 2.f/filterControlRate; // SVF ticks, coefficients are calculated at control rate (see ControlRateSVF)
+
+		for (const auto &voiceOp : voice.m_operators)
+		{
+			if (true == voiceOp.enabled)
+			{
+				cost += 2.f; // Interpolated parameters, envelope, panning
+				cost += GetWaveformCost(voiceOp.oscillator.GetWaveform());
+
+				if (bq_type_none != voiceOp.filter.getType())
+					cost += 1.f;
+				else if (SvfLinearTrapOptimised2::NO_FLT_TYPE != voiceOp.modFilter.getFilterType())
+					cost += 0.5f;
+			}
+		}
+
+		return cost;
+	}
+
+	/* static */ void Bison::VoiceRenderThread(void *pContext, unsigned iJob, unsigned iThread)
 	{
-		SFM_ASSERT(nullptr != pInst);
 		SFM_ASSERT(nullptr != pContext);
-		pInst->RenderVoices(pContext->parameters, pContext->voiceIndices, pContext->numSamples, pContext->pDestL, pContext->pDestR);
+		VoiceThreadContext &context = *reinterpret_cast<VoiceThreadContext *>(pContext);
+
+		// Runs on behalf of Render()
+		NoAllocationScope noAllocation;
+
+		Bison *pInst = context.pInst;
+		SFM_ASSERT(nullptr != pInst);
+
+		float *pDestL = pInst->m_pBufL[iThread];
+		float *pDestR = pInst->m_pBufR[iThread];
+
+		// First voice this thread renders this block?
+		if (false == context.threadUsed[iThread])
+		{
+			memset(pDestL, 0, context.numSamples*sizeof(float));
+			memset(pDestR, 0, context.numSamples*sizeof(float));
+
+			context.threadUsed[iThread] = true;
+		}
+
+		const VoiceJob &job = context.pJobs[iJob];
+		const unsigned *pVoiceIndices = context.pVoiceIndices + job.first;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		if (1 == job.count)
+			pInst->RenderVoice(context.parameters, pVoiceIndices[0], context.numSamples, pDestL, pDestR);
+		else
+			pInst->RenderVoiceLanes(context.parameters, pVoiceIndices, job.count, context.numSamples, pDestL, pDestR);
+
+		const float elapsed = std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now()-start).count();
+
+		// Keep track of measured time (smoothed a little, a thread can always get preempted); voices in lanes split it evenly
+		for (unsigned iVoice = 0; iVoice < job.count; ++iVoice)
+		{
+			VoiceCost &cost = pInst->m_voiceCosts[pVoiceIndices[iVoice]];
+			if (cost.numSamples > 0)
+			{
+				const float timePerSample = elapsed/(job.count*cost.numSamples);
+				cost.timePerSample = (0.f == cost.timePerSample)
+					? timePerSample
+					: lerpf<float>(cost.timePerSample, timePerSample, 0.5f);
+			}
+		}
 	}
 
-	// Renders a set of voices
-	// - Stick to variables supplied through a context *or* make very sure you read only!
-	// - Assumes that each voice is active
-	void Bison::RenderVoices(const VoiceRenderParameters &context, const std::vector<unsigned> &voiceIndices, unsigned numSamples, float *pDestL, float *pDestR) const
+	unsigned Bison::GetNumVoiceLanes(const unsigned *pVoiceIndices, unsigned numVoices) const
 	{
-		SFM_ASSERT(nullptr != pDestL && nullptr != pDestR);
+		SFM_ASSERT(nullptr != pVoiceIndices && numVoices > 0);
+
+		const Voice &first = m_voices[pVoiceIndices[0]];
+		if (false == VoiceLanes::IsEligible(first))
+			return 1;
+
+		unsigned numLanes = 1;
+		while (numLanes < numVoices && numLanes < kVoiceLanes)
+		{
+			const Voice &voice = m_voices[pVoiceIndices[numLanes]];
+			if (false == VoiceLanes::IsEligible(voice) || false == VoiceLanes::IsCompatible(first, voice))
+				break;
+
+			++numLanes;
+		}
+
+		return numLanes;
+	}
+
+	// Renders (and thereby advances) global parameters for this block, so that voices needn't each interpolate them
+	void Bison::RenderModulationBus(const VoiceRenderParameters &context, const VoiceIndices &voiceIndices, unsigned numSamples)
+	{
+		SFM_ASSERT(numSamples <= m_samplesPerBlock);
+
+		const ModulationBus &bus = m_modBus;
+
+		// If not interpolating the pitch bend is the same for the entire block
+		const bool constantBend = m_curPitchBend.IsDone();
+
+		m_curAftertouch.RenderBlock(bus.pAftertouch, numSamples);
+		m_curPitchBend.RenderBlock(bus.pPitchBend, numSamples);
+		m_curAmpBend.RenderBlock(bus.pAmpBend, numSamples);
+		m_curLFOBlend.RenderBlock(bus.pLFOBlend, numSamples);
+		m_curLFOModDepth.RenderBlock(bus.pLFOModDepth, numSamples);
+
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			bus.pModulation[iSample] = std::min<float>(1.f, m_curModulation.Sample() + context.modulationAftertouch*bus.pAftertouch[iSample]);
+
+		if (SvfLinearTrapOptimised2::NO_FLT_TYPE != context.filterType)
+		{
+			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			{
+				// SVF cutoff aftertouch (curved towards zero if pressed)
+				const float cutAfter = context.mainFilterAftertouch*bus.pAftertouch[iSample];
+				SFM_ASSERT_NORM(cutAfter);
+
+				bus.pCutoff[iSample] = m_curCutoff.Sample()*(1.f - cutAfter*kMainCutoffAftertouchRange); // More pressure -> lower cutoff freq.
+			}
+
+			m_curQ.RenderBlock(bus.pQ, numSamples);
+		}
+		else
+		{
+			m_curCutoff.Skip(numSamples);
+			m_curQ.Skip(numSamples);
+		}
+
+		// Pitch bend multiplier for each bend range in use (typically just the one)
+		bool rangeDone[kMaxPitchBendRange+1] = { false };
 
 		for (auto iVoice : voiceIndices)
 		{
-			Voice &voice = const_cast<Voice&>(m_voices[iVoice]);
-			SFM_ASSERT(false == voice.IsIdle());
+			const int range = m_voices[iVoice].m_pitchBendRange;
+			SFM_ASSERT(range >= 0 && range <= int(kMaxPitchBendRange));
 
-			// Update LFO frequencies
-			float frequency = m_globalLFO->GetFrequency(), modFrequency;
-			CalcLFOFreq(frequency, modFrequency, m_patch.LFOModSpeed);
-			
-			voice.m_LFO1.SetFrequency(frequency);
-			voice.m_LFO2.SetFrequency(frequency);
-			voice.m_modLFO.SetFrequency(modFrequency);
-			
-			// Update LFO S&H parameters
-			const float slewRate = m_patch.SandHSlewRate;
-			voice.m_LFO1.SetSampleAndHoldSlewRate(slewRate);
-			voice.m_LFO2.SetSampleAndHoldSlewRate(slewRate);
-			voice.m_modLFO.SetSampleAndHoldSlewRate(slewRate);
+			if (true == rangeDone[range])
+				continue;
 
-			if (true == m_resetPhaseBPM)
+			float *pPitchBendMul = bus.pPitchBendMul[range];
+
+			if (true == constantBend)
 			{
-				// If resetting BPM sync. phase initiate a fade in
-				voice.m_globalAmp.SetRate(m_sampleRate, kGlobalAmpCutTime);
-				voice.m_globalAmp.Set(0.f);
-				voice.m_globalAmp.SetTarget(kVoiceGain);
+				const float pitchBendMul = CalcPitchBendMul(bus.pPitchBend[0], range);
+				for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+					pPitchBendMul[iSample] = pitchBendMul;
 			}
-	
-			if (true == context.resetFilter)
+			else
 			{
-				// Reset
-				voice.m_filterSVF.resetState();
+				for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+					pPitchBendMul[iSample] = CalcPitchBendMul(bus.pPitchBend[iSample], range);
 			}
 
-			// LFO
-			auto curLFOBlend    = m_curLFOBlend;
-			auto curLFOModDepth = m_curLFOModDepth;
+			rangeDone[range] = true;
+		}
+	}
 
-			// Reset to initial cutoff & Q
-			auto curCutoff = m_curCutoff;
-			auto curQ      = m_curQ;
+	// Renders a set of voices
+	void Bison::RenderVoices(const VoiceRenderParameters &context, const VoiceIndices &voiceIndices, unsigned numSamples, float *pDestL, float *pDestR) const
+	{
+		const unsigned numVoices = voiceIndices.size();
 
-			// Reset to initial pitch/amp. bend & modulation
-			auto curPitchBend  = m_curPitchBend;
-			auto curAmpBend    = m_curAmpBend;
-			auto curModulation = m_curModulation;
+		for (unsigned iIndex = 0; iIndex < numVoices;)
+		{
+			// Voices that share topology are rendered in lanes, the order (of summation) stays the same
+			const unsigned *pVoiceIndices = voiceIndices.data() + iIndex;
+			const unsigned numLanes = GetNumVoiceLanes(pVoiceIndices, numVoices-iIndex);
 
-			// Reset to initial aftertouch
-			auto curAftertouch = m_curAftertouch;
+			if (1 == numLanes)
+				RenderVoice(context, pVoiceIndices[0], numSamples, pDestL, pDestR);
+			else
+				RenderVoiceLanes(context, pVoiceIndices, numLanes, numSamples, pDestL, pDestR);
 
-			const bool noFilter = SvfLinearTrapOptimised2::NO_FLT_TYPE == context.filterType;
-			auto& filterEG      = voice.m_filterEnvelope;
-			
-			// FIXME: split up in passes, so as to trade memory bandwidth for reduced read cache (misses)?
-			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
-			{
-				const float sampAftertouch = curAftertouch.Sample();
+			iIndex += numLanes;
+		}
+	}
+
+	// Per block voice setup, called by RenderVoice() & RenderVoiceLanes()
+	void Bison::PrepareVoice(const VoiceRenderParameters &context, Voice &voice) const
+	{
+		// Update LFO frequencies
+		float frequency = m_globalLFO->GetFrequency(), modFrequency;
+		CalcLFOFreq(frequency, modFrequency, m_pPatch->LFOModSpeed);
+		
+		voice.m_LFO1.SetFrequency(frequency);
+		voice.m_LFO2.SetFrequency(frequency);
+		voice.m_modLFO.SetFrequency(modFrequency);
+		
+		// Update LFO S&H parameters
+		const float slewRate = m_pPatch->SandHSlewRate;
+		voice.m_LFO1.SetSampleAndHoldSlewRate(slewRate);
+		voice.m_LFO2.SetSampleAndHoldSlewRate(slewRate);
+		voice.m_modLFO.SetSampleAndHoldSlewRate(slewRate);
+
+		if (true == m_resetPhaseBPM)
+		{
+			// If resetting BPM sync. phase initiate a fade in
+			voice.m_globalAmp.SetRate(m_sampleRate, kGlobalAmpCutTime);
+			voice.m_globalAmp.Set(0.f);
+			voice.m_globalAmp.SetTarget(kVoiceGain);
+		}
+	
+		if (true == context.resetFilter)
+		{
+			// Reset
+			voice.m_filterSVF.Reset();
+		}
+	}
+
+	// Renders a single voice (may be called on any of the pool's threads)
+	// - Stick to variables supplied through a context *or* make very sure you read only!
+	// - Assumes that the voice is active
+	void Bison::RenderVoice(const VoiceRenderParameters &context, unsigned iVoice, unsigned numSamples, float *pDestL, float *pDestR) const
+	{
+		SFM_ASSERT(nullptr != pDestL && nullptr != pDestR);
+
+		Voice &voice = const_cast<Voice&>(m_voices[iVoice]);
+		SFM_ASSERT(false == voice.IsIdle());
+
+		PrepareVoice(context, voice);
+
+		// Global parameters (see RenderModulationBus())
+		const ModulationBus &bus = m_modBus;
+		const float *pPitchBendMul = bus.pPitchBendMul[voice.m_pitchBendRange];
+
+		const bool noFilter = SvfLinearTrapOptimised2::NO_FLT_TYPE == context.filterType;
+		auto& filterEG      = voice.m_filterEnvelope;
+
+		// Apply main filter to & mix a single sample
+		auto filterAndMix = [&](float left, float right, unsigned iSample)
+		{
+			// Sample filter envelope
+			float filterEnv = filterEG.Sample();
+			if (true == m_pPatch->filterEnvInvert)
+				filterEnv = 1.f-filterEnv;
+
+#if !defined(SFM_DISABLE_FX)						
+
+			// Apply & mix filter
+			if (false == noFilter)
+			{	
+				float filteredL = left;
+				float filteredR = right;
+						
+				// Cutoff & Q, finally, for *this* sample
+				const float cutoffHz = lerpf<float>(context.fullCutoff, bus.pCutoff[iSample], filterEnv);
+				const float sampQ = bus.pQ[iSample];
 
-				const float sampMod = std::min<float>(1.f, curModulation.Sample() + context.modulationAftertouch*sampAftertouch);
+				// Ref.: https://github.com/FredAntonCorvest/Common-DSP/blob/master/Filter/SvfLinearTrapOptimised2Demo.cpp
+				voice.m_filterSVF.Update(cutoffHz, sampQ, context.filterType, m_sampleRate, m_filterControlRate);
+				voice.m_filterSVF.Tick(filteredL, filteredR);
 						
-				// Render dry voice
-				float left, right;
-				voice.Sample(
-					left, right, 
-					curPitchBend.Sample(),
-					curAmpBend.Sample(),
-					sampMod,
-					curLFOBlend.Sample(), 
-					curLFOModDepth.Sample());
+				left  = filteredL;
+				right = filteredR;
+			}
+
+#endif
+
+			// Add to mix
+			pDestL[iSample] += left;
+			pDestR[iSample] += right;
+		};
+
+#if !defined(SFM_DISABLE_BLOCK_VOICE_RENDER)
+
+		// Render in stages, per sub-block: dry voice (see Voice::Render()), filter & mix
+		alignas(16) float voiceL[kVoiceBlockSize], voiceR[kVoiceBlockSize];
+
+		for (unsigned iOffs = 0; iOffs < numSamples; iOffs += kVoiceBlockSize)
+		{
+			const unsigned numSubSamples = std::min<unsigned>(kVoiceBlockSize, numSamples-iOffs);
+
+			voice.Render(numSubSamples, pPitchBendMul+iOffs, bus.pAmpBend+iOffs, bus.pModulation+iOffs, bus.pLFOBlend+iOffs, bus.pLFOModDepth+iOffs, voiceL, voiceR);
+
+			for (unsigned iSample = 0; iSample < numSubSamples; ++iSample)
+				filterAndMix(voiceL[iSample], voiceR[iSample], iOffs+iSample);
+		}
+
+#else
+
+		// Reference: render sample by sample
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			// Render dry voice
+			float left, right;
+			voice.SampleWithBendMul(
+				left, right, 
+				pPitchBendMul[iSample],
+				bus.pAmpBend[iSample],
+				bus.pModulation[iSample],
+				bus.pLFOBlend[iSample], 
+				bus.pLFOModDepth[iSample]);
+
+			filterAndMix(left, right, iSample);
+		}
+
+#endif
+	}
+
+	// Renders a group of voices in lockstep (see synth-voice-lanes.h), same rules as RenderVoice() apply
+	// - Voices must be eligible & share topology (see GetNumVoiceLanes())
+	// - Output is mixed in voice order, so it's identical to calling RenderVoice() for each voice
+	void Bison::RenderVoiceLanes(const VoiceRenderParameters &context, const unsigned *pVoiceIndices, unsigned numVoices, unsigned numSamples, float *pDestL, float *pDestR) const
+	{
+		SFM_ASSERT(nullptr != pVoiceIndices && numVoices > 1 && numVoices <= kVoiceLanes);
+		SFM_ASSERT(nullptr != pDestL && nullptr != pDestR);
+
+		Voice *voices[kVoiceLanes] = {};
+		for (unsigned iLane = 0; iLane < numVoices; ++iLane)
+		{
+			Voice &voice = const_cast<Voice&>(m_voices[pVoiceIndices[iLane]]);
+			SFM_ASSERT(false == voice.IsIdle());
+
+			PrepareVoice(context, voice);
+
+			voices[iLane] = &voice;
+		}
+
+		VoiceLanes lanes;
+		lanes.Load(voices, numVoices);
+
+		// Parameters are shared by all voices (see RenderModulationBus()), save for the pitch bend range
+		const ModulationBus &bus = m_modBus;
+
+		const float *pPitchBendMul[kVoiceLanes] = { nullptr };
+		for (unsigned iLane = 0; iLane < numVoices; ++iLane)
+			pPitchBendMul[iLane] = bus.pPitchBendMul[voices[iLane]->m_pitchBendRange];
+
+		const bool noFilter = SvfLinearTrapOptimised2::NO_FLT_TYPE == context.filterType;
+
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			float pitchBendMul[kVoiceLanes];
+			for (unsigned iLane = 0; iLane < numVoices; ++iLane)
+				pitchBendMul[iLane] = pPitchBendMul[iLane][iSample];
+
+			// Render dry voices
+			float left[kVoiceLanes], right[kVoiceLanes];
+			lanes.Sample(
+				left, right,
+				pitchBendMul,
+				bus.pAmpBend[iSample],
+				bus.pModulation[iSample],
+				bus.pLFOBlend[iSample],
+				bus.pLFOModDepth[iSample]);
+
+			// Cutoff (minus envelope) & Q for *this* sample
+			float nonEnvCutoffHz = 0.f, sampQ = 0.f;
+			if (false == noFilter)
+			{
+				nonEnvCutoffHz = bus.pCutoff[iSample];
+				sampQ = bus.pQ[iSample];
+			}
+
+			for (unsigned iLane = 0; iLane < numVoices; ++iLane)
+			{
+				Voice &voice = *voices[iLane];
 
 				// Sample filter envelope
-				float filterEnv = filterEG.Sample();
-				if (true == m_patch.filterEnvInvert)
+				float filterEnv = voice.m_filterEnvelope.Sample();
+				if (true == m_pPatch->filterEnvInvert)
 					filterEnv = 1.f-filterEnv;
 
-				// SVF cutoff aftertouch (curved towards zero if pressed)
-				const float cutAfter = context.mainFilterAftertouch*sampAftertouch;
-				SFM_ASSERT_NORM(cutAfter);
-			
-#if !defined(SFM_DISABLE_FX)						
+#if !defined(SFM_DISABLE_FX)
 
-				// Apply & mix filter (FIXME: move to sequential loop?)
+				// Apply filter
 				if (false == noFilter)
-				{	
-					float filteredL = left;
-					float filteredR = right;
-							
-					// Cutoff & Q, finally, for *this* sample
-					const float nonEnvCutoffHz = curCutoff.Sample()*(1.f - cutAfter*kMainCutoffAftertouchRange); // More pressure -> lower cutoff freq.
+				{
 					const float cutoffHz = lerpf<float>(context.fullCutoff, nonEnvCutoffHz, filterEnv);
-					const float sampQ = curQ.Sample();
 
-					// Ref.: https://github.com/FredAntonCorvest/Common-DSP/blob/master/Filter/SvfLinearTrapOptimised2Demo.cpp
-					voice.m_filterSVF.updateCoefficients(cutoffHz, sampQ, context.filterType, m_sampleRate);
-					voice.m_filterSVF.tick(filteredL, filteredR);
-							
-					left  = filteredL;
-					right = filteredR;
+					voice.m_filterSVF.Update(cutoffHz, sampQ, context.filterType, m_sampleRate, m_filterControlRate);
+					voice.m_filterSVF.Tick(left[iLane], right[iLane]);
 				}
 
 #endif
 
 				// Add to mix
-				pDestL[iSample] += left;
-				pDestR[iSample] += right;
+				pDestL[iSample] += left[iLane];
+				pDestR[iSample] += right[iLane];
 			}
 		}
+
+		lanes.Store();
 	}
 
 	/* ----------------------------------------------------------------------------------------------------
@@ -1672,7 +2262,20 @@ namespace SFM
 
 	 ------------------------------------------------------------------------------------------------------ */
 	
+	void Bison::Render(unsigned numSamples, float *pLeft, float *pRight)
+	{
+		RenderScheduled(numSamples, true, 0.f, 0.f, 0.f, pLeft, pRight);
+	}
+
 	void Bison::Render(unsigned numSamples, float bendWheel, float modulation, float aftertouch, float *pLeft, float *pRight)
+	{
+		RenderScheduled(numSamples, false, bendWheel, modulation, aftertouch, pLeft, pRight);
+	}
+
+	// Splits block at (quantized) event time stamps: each event is handled right before the part it takes effect in
+	// Note-ons aren't quantized nor do they split the block, since voices start at their exact time stamp anyway
+	// Only voices (and controllers) are rendered per part, the post-pass processes the entire block at once
+	void Bison::RenderScheduled(unsigned numSamples, bool eventControllers, float bendWheel, float modulation, float aftertouch, float *pLeft, float *pRight)
 	{
 		SFM_ASSERT_BINORM(bendWheel); 
 		SFM_ASSERT_NORM(modulation);
@@ -1680,7 +2283,6 @@ namespace SFM
 		
 		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
 		SFM_ASSERT(nullptr != m_pBufL[0] && nullptr != m_pBufR[0]);
-		SFM_ASSERT(nullptr != m_pBufL[1] && nullptr != m_pBufR[1]);
 
 		if (numSamples > m_samplesPerBlock)
 		{
@@ -1694,10 +2296,136 @@ namespace SFM
 		DisableDenormals disableDEN;
 #endif
 
+		// Render() must not allocate (only checked if SFM_DETECT_RENDER_ALLOCATIONS is defined)
+		NoAllocationScope noAllocation;
+
+		// Use latest published patch
+		UpdatePatch();
+
+		// Schedule events posted by other threads
+		DrainEvents();
+
+		// Asleep? Stay that way until an event is due (see SetSleep())
+		if (true == m_isAsleep)
+		{
+			const bool isEventDue = false == m_schedule.empty() && m_schedule[0].timeStamp < numSamples; // Schedule is sorted
+
+			if (false == isEventDue && 0 != m_sleepNumBlocks)
+			{
+				memset(pLeft,  0, numSamples*sizeof(float));
+				memset(pRight, 0, numSamples*sizeof(float));
+
+				for (auto &event : m_schedule)
+					event.timeStamp -= numSamples;
+
+				m_sampleClock += numSamples;
+				m_numSleptSamples += numSamples;
+
+				return;
+			}
+
+			Wake();
+		}
+
+		// Clear L/R buffers (voices are mixed into these part by part)
+		memset(m_pBufL[0], 0, numSamples*sizeof(float));
+		memset(m_pBufR[0], 0, numSamples*sizeof(float));
+
+		const unsigned numEvents = m_schedule.size();
+		unsigned iEvent = 0;
+
+		unsigned offset = 0;
+		while (offset < numSamples)
+		{
+			unsigned end = numSamples;
+
+			// Handle events that are due, up until the first one that isn't
+			while (iEvent < numEvents)
+			{
+				const Event &event = m_schedule[iEvent];
+				
+				// Next Render() call (schedule is sorted)
+				if (event.timeStamp >= numSamples)
+					break;
+
+				if (Event::kNoteOn != event.type)
+				{
+					const unsigned quantized = event.timeStamp - event.timeStamp%m_eventGrid;
+					if (quantized > offset)
+					{
+						end = quantized;
+						break;
+					}
+				}
+
+				ApplyEvent(event, offset);
+				++iEvent;
+			}
+
+			if (true == eventControllers)
+			{
+				bendWheel  = m_eventBendWheel;
+				modulation = m_eventModulation;
+				aftertouch = m_eventAftertouch;
+			}
+
+			RenderBlock(offset, end-offset, bendWheel, modulation, aftertouch);
+
+			offset = end;
+		}
+
+		if (0 != numSamples)
+			ApplyPostPass(numSamples, pLeft, pRight);
+
+		// Remove handled events, the rest is due in the next Render() call(s)
+		m_schedule.erase(m_schedule.begin(), m_schedule.begin()+iEvent);
+
+		for (auto &event : m_schedule)
+			event.timeStamp -= numSamples;
+
+		// Fall asleep if there's been nothing (audible) going on for long enough
+		if (0 != m_sleepNumBlocks)
+		{
+			const bool isSilent = 0 == m_voiceCount && true == m_postPass->IsSilent() && GetRectifiedMaximum(pLeft, pRight, numSamples) <= m_sleepFloor;
+			m_numSilentBlocks = (true == isSilent) ? m_numSilentBlocks+1 : 0;
+
+			if (m_numSilentBlocks >= m_sleepNumBlocks)
+			{
+				m_isAsleep = true;
+				m_numSleptSamples = 0;
+			}
+		}
+	}
+
+	void Bison::SkipSlept()
+	{
+		// Supersaws & global LFO catch up by themselves (see m_sampleClock)
+		m_postPass->SkipFreeRunning(m_numSleptSamples);
+
+		m_numSleptSamples = 0;
+	}
+
+	void Bison::Wake()
+	{
+		SFM_ASSERT(true == m_isAsleep);
+
+		SkipSlept();
+
+		// Interpolated parameters are snapped to their targets by RenderBlock()
+		m_isWaking = true;
+
+		m_isAsleep = false;
+		m_numSilentBlocks = 0;
+	}
+
+	void Bison::RenderBlock(unsigned offset, unsigned numSamples, float bendWheel, float modulation, float aftertouch)
+	{
+		SFM_ASSERT(numSamples > 0 && offset+numSamples <= m_samplesPerBlock);
+
 		const bool monophonic = Patch::VoiceMode::kMono == m_curVoiceMode;
 
 		// Reset voices if polyphony changes
-		const unsigned maxVoices = (false == monophonic) ? m_patch.maxPolyVoices : 1;
+		const unsigned maxVoices = (false == monophonic) ? m_pPatch->maxPolyVoices : 1;
 		if (m_curPolyphony != maxVoices)
 		{
 			m_resetVoices = true;
@@ -1705,26 +2433,21 @@ namespace SFM
 		}
 
 		// Modulation override?
-		if (0.f != m_patch.modulationOverride)
+		if (0.f != m_pPatch->modulationOverride)
 		{
-			SFM_ASSERT(m_patch.modulationOverride > 0.f && m_patch.modulationOverride <= 1.f);
-			modulation = m_patch.modulationOverride;
+			SFM_ASSERT(m_pPatch->modulationOverride > 0.f && m_pPatch->modulationOverride <= 1.f);
+			modulation = m_pPatch->modulationOverride;
 		}
 
 		// Calculate current BPM freq.
-		unsigned overrideDelayBit = 0;
-		if (true == m_patch.beatSync && 0.f != m_BPM)
+		if (true == m_pPatch->beatSync && 0.f != m_BPM)
 		{
-			const float ratio = m_patch.beatSyncRatio; // Note ratio
+			const float ratio = m_pPatch->beatSyncRatio; // Note ratio
 			SFM_ASSERT(ratio >= 0);
 
 			const float BPM = m_BPM;
 			const float BPS = BPM/60.f;    // Beats per sec.
 			m_freqBPM = BPS/ratio;         // Sync. freq.
-			
-			// If can't fit delay within it's line, revert to manual setting
-			if (1.f/m_freqBPM >= kMainDelayInSec)
-				overrideDelayBit = kFlagOverrideDelay;
 		}
 		else
 			// None: interpret this as a cue to use user controlled rate(s)
@@ -1733,12 +2456,12 @@ namespace SFM
 		// Calculate LFO freq.
 		float freqLFO = 0.f;
 
-		const bool overrideLFO = m_patch.syncOverride & kFlagOverrideLFO;
-		if (false == m_patch.beatSync || m_freqBPM == 0.f || true == overrideLFO)
+		const bool overrideLFO = m_pPatch->syncOverride & kFlagOverrideLFO;
+		if (false == m_pPatch->beatSync || m_freqBPM == 0.f || true == overrideLFO)
 		{
 			// Set LFO speed in (DX7) range
-			freqLFO = MIDI_To_DX7_LFO_Hz(m_patch.LFORate);
-			m_globalLFO->SetFrequency(freqLFO); // FIXME: LPF?
+			freqLFO = MIDI_To_DX7_LFO_Hz(m_pPatch->LFORate);
+			SetGlobalLFOFrequency(freqLFO); // FIXME: LPF?
 		}
 		else
 		{
@@ -1747,33 +2470,41 @@ namespace SFM
 
 			if (false == m_resetPhaseBPM)
 			{
-				m_globalLFO->SetFrequency(freqLFO); // FIXME: LPF?
+				SetGlobalLFOFrequency(freqLFO); // FIXME: LPF?
 			}
 			else
 			{
 				// Full reset; likely to be used when (re)starting a track
 				// This *must* be done prior to UpdateVoicesPreRender()
 				m_globalLFO->Initialize(freqLFO, m_sampleRate);
+				m_globalLFOClock = m_sampleClock;
 
 				// FIXME: this is where one would reinitialize possible interpolation of LFO rate (removed along with ParameterSlew @ 1/11/2021)
 			}
 		}
 		
 		// Set (interpolated) LFO parameters
-		m_curLFOBlend.SetTarget(m_patch.LFOBlend);
-		m_curLFOModDepth.SetTarget(m_patch.LFOModDepth);
+		m_curLFOBlend.SetTarget(m_pPatch->LFOBlend);
+		m_curLFOModDepth.SetTarget(m_pPatch->LFOModDepth);
 
 		// Update voice logic (PRE)
 		UpdateVoicesPreRender();
 
+		// Sustain changed (by event) at the start of this block?
+		if (true == m_sustainChanged)
+		{
+			UpdateSustain();
+			m_sustainChanged = false;
+		}
+
 		// Update filter type & state
 		//
 
 		SvfLinearTrapOptimised2::FLT_TYPE filterType;
 		
 		// Set target cutoff (Hz) & Q
-		const float normCutoff = m_patch.cutoff;
-		const float resonance = m_patch.resonance;
+		const float normCutoff = m_pPatch->cutoff;
+		const float resonance = m_pPatch->resonance;
 
 		// Using smoothstepf() to add a little curvature, chiefly intended to appease basic MIDI controls
 		const float cutoff = SVF_CutoffToHz(smoothstepf(normCutoff), m_Nyquist);
@@ -1788,23 +2519,23 @@ namespace SFM
 		SFM_ASSERT_NORM(normQ);
 
 		float Q;
-		switch (m_patch.filterType)
+		switch (m_pPatch->filterType)
 		{
 		default:
 		case Patch::kNoFilter:
 			filterType = SvfLinearTrapOptimised2::NO_FLT_TYPE;
-			Q = SVF_ResoToQ(normQ*m_patch.resonanceLimit);
+			Q = SVF_ResoToQ(normQ*m_pPatch->resonanceLimit);
 			break;
 
 		case Patch::kLowpassFilter:
 			// Screams and yells
 			filterType = SvfLinearTrapOptimised2::LOW_PASS_FILTER;
-			Q = SVF_ResoToQ(normQ*m_patch.resonanceLimit);
+			Q = SVF_ResoToQ(normQ*m_pPatch->resonanceLimit);
 			break;
 
 		case Patch::kHighpassFilter:
 			filterType = SvfLinearTrapOptimised2::HIGH_PASS_FILTER;
-			Q = SVF_ResoToQ(normQ*m_patch.resonanceLimit);
+			Q = SVF_ResoToQ(normQ*m_pPatch->resonanceLimit);
 			break;
 
 		case Patch::kBandpassFilter:
@@ -1828,7 +2559,7 @@ namespace SFM
 
 		// Set pitch & amp. wheel & modulation target values
 		const float bendWheelFiltered = bendWheel;
-		if (false == m_patch.pitchIsAmpMod)
+		if (false == m_pPatch->pitchIsAmpMod)
 		{
 			// Wheel modulates pitch
 			m_curPitchBend.SetTarget(bendWheelFiltered);
@@ -1847,9 +2578,24 @@ namespace SFM
 		const float aftertouchFiltered = aftertouch; // FIXME: LPF?
 		m_curAftertouch.SetTarget(aftertouchFiltered);
 
-		// Clear L/R buffers
-		memset(m_pBufL[0], 0, m_samplesPerBlock*sizeof(float));
-		memset(m_pBufR[0], 0, m_samplesPerBlock*sizeof(float));
+		// Woke up (see Wake()): nothing has been heard in the meantime, so there's nothing to interpolate from
+		if (true == m_isWaking)
+		{
+			m_curLFOBlend.Set(m_curLFOBlend.GetTarget());
+			m_curLFOModDepth.Set(m_curLFOModDepth.GetTarget());
+			m_curCutoff.Set(m_curCutoff.GetTarget());
+			m_curQ.Set(m_curQ.GetTarget());
+			m_curPitchBend.Set(m_curPitchBend.GetTarget());
+			m_curAmpBend.Set(m_curAmpBend.GetTarget());
+			m_curModulation.Set(m_curModulation.GetTarget());
+			m_curAftertouch.Set(m_curAftertouch.GetTarget());
+
+			m_isWaking = false;
+		}
+
+		// Destination (cleared by RenderScheduled())
+		float *pDestL = m_pBufL[0] + offset;
+		float *pDestR = m_pBufR[0] + offset;
 
 		// Start rendering voices, if necessary
 		const unsigned numVoices = m_voiceCount;
@@ -1857,8 +2603,8 @@ namespace SFM
 		if (0 != numVoices)
 		{
 			// Swap 2 branches for multiplications later on
-			const float mainFilterAftertouch = (Patch::kMainFilter == m_patch.aftertouchMod) ? 1.f : 0.f;
-			const float modulationAftertouch = (Patch::kModulation == m_patch.aftertouchMod) ? 1.f : 0.f;
+			const float mainFilterAftertouch = (Patch::kMainFilter == m_pPatch->aftertouchMod) ? 1.f : 0.f;
+			const float modulationAftertouch = (Patch::kModulation == m_pPatch->aftertouchMod) ? 1.f : 0.f;
 
 			VoiceRenderParameters parameters;
 			parameters.freqLFO = freqLFO;
@@ -1869,85 +2615,110 @@ namespace SFM
 			parameters.mainFilterAftertouch = mainFilterAftertouch;
 
 			// Build array of voices to render
-			std::vector<unsigned> voiceIndices;
+			VoiceIndices voiceIndices;
 			for (int iVoice = 0; iVoice < kMaxPolyVoices /* Actual voice count can be > m_curPolyphony */; ++iVoice)
 			{
 				if (false == m_voices[iVoice].IsIdle())
 					voiceIndices.push_back(iVoice);
 			}
 
-#if defined(SFM_DISABLE_VOICE_THREAD)
-			if (/* DISABLES CODE */ (true))
-#else
-			if (voiceIndices.size() <= kSingleThreadMaxVoices || numSamples < kMultiThreadMinSamples)
-#endif
+			// Render global parameters once for all voices
+			RenderModulationBus(parameters, voiceIndices, numSamples);
+
+			if (nullptr == m_threadPool || voiceIndices.size() <= kSingleThreadMaxVoices || numSamples < kMultiThreadMinSamples)
 			{
 				// Render all voices on current thread
-				VoiceThreadContext context(parameters);
-				context.voiceIndices = std::move(voiceIndices);
-				context.numSamples = numSamples;
-				context.pDestL = m_pBufL[0];
-				context.pDestR = m_pBufR[0];
-			
-				VoiceRenderThread(this, &context);
+				RenderVoices(parameters, voiceIndices, numSamples, pDestL, pDestR);
 			}
 			else
 			{
-				// Clear L/R buffers
-				memset(m_pBufL[1], 0, m_samplesPerBlock*sizeof(float));
-				memset(m_pBufR[1], 0, m_samplesPerBlock*sizeof(float));
-				
-				// Use 2 (current plus one extra) threads to render voices
-				VoiceThreadContext contexts[2] = { parameters, parameters };
-				
-				// Split voices up 50/50
-				const size_t half = voiceIndices.size() / 2;
-				contexts[0].voiceIndices = std::vector<unsigned>(voiceIndices.begin(), voiceIndices.begin() + half);
-				contexts[1].voiceIndices = std::vector<unsigned>(voiceIndices.begin() + half, voiceIndices.end());
+				// Calculate expected cost of each voice
+				const bool hasMainFilter = SvfLinearTrapOptimised2::NO_FLT_TYPE != filterType;
 
-				contexts[0].numSamples = contexts[1].numSamples = numSamples;
+				for (auto iVoice : voiceIndices)
+				{
+					const Voice &voice = m_voices[iVoice];
+					VoiceCost &cost = m_voiceCosts[iVoice];
 
-				contexts[0].pDestL = m_pBufL[0];
-				contexts[0].pDestR = m_pBufR[0];
-				contexts[1].pDestL = m_pBufL[1];
-				contexts[1].pDestR = m_pBufR[1];
+					// Samples before the offset are close to free
+					cost.numSamples = numSamples - std::min<unsigned>(voice.m_sampleOffs, numSamples);
+					cost.estimate = EstimateVoiceCost(voice, hasMainFilter, m_filterControlRate);
 
-				std::thread thread(VoiceRenderThread, this, &contexts[1]);
+					// Use measurement if available
+					const float timePerSample = (0.f != cost.timePerSample) ? cost.timePerSample : cost.estimate*m_timePerCostUnit;
+					cost.expected = timePerSample*cost.numSamples;
+				}
 
-				VoiceRenderThread(this, &contexts[0]); // Process our part
-				thread.join();                         // Wait for thread
+				// Most expensive voices first: since threads grab voices one by one this balances the load across threads
+				// (or 'longest processing time first'), the cheaper voices fill up the gaps at the end
+				std::sort(voiceIndices.begin(), voiceIndices.end(), [this](unsigned iA, unsigned iB)
+				{
+					return m_voiceCosts[iA].expected > m_voiceCosts[iB].expected;
+				});
 
-				// Mix samples (FIXME: could move to PostPass but if all is well we've already won at least *some* CPU if necessary)
-				for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+				// Group (neighbouring) voices that can be rendered in lanes; order by cost is kept as well as it can be
+				const unsigned numIndices = voiceIndices.size();
+
+				FixedVector<VoiceJob, kMaxPolyVoices> jobs;
+				for (unsigned iIndex = 0; iIndex < numIndices;)
 				{
-					m_pBufL[0][iSample] += m_pBufL[1][iSample];
-					m_pBufR[0][iSample] += m_pBufR[1][iSample];
+					const unsigned numLanes = GetNumVoiceLanes(voiceIndices.data() + iIndex, numIndices-iIndex);
+					jobs.push_back({ iIndex, numLanes });
+					iIndex += numLanes;
 				}
-			}
-		}
 
-		// Keep *all* supersaw oscillators running; I could move this loop to RenderVoices(), but that would clutter up the function a bit,
-		// and here it's easy to follow and easy to extend
-		// FIXME: review this (see Github issue: https://github.com/bipolaraudio/FM-BISON/issues/235)
+				// Let the pool's threads (including this one) grab jobs one by one until there are none left
+				VoiceThreadContext context(this, parameters);
+				context.pVoiceIndices = voiceIndices.data();
+				context.pJobs = jobs.data();
+				context.numSamples = numSamples;
 
-//		const bool monophonic = Patch::VoiceMode::kMono == m_patch.voiceMode;
-		for (auto &voice : m_voices)
-		{	
-			const bool isIdle = voice.IsIdle() && !monophonic;
+				m_threadPool->Run(VoiceRenderThread, &context, jobs.size());
 
-			for (auto &voiceOp : voice.m_operators)
-			{
-				// Only update if *not* in use
-				if (true == isIdle || false == voiceOp.enabled)
+				// Mix samples of each thread that took part (FIXME: could move to PostPass but if all is well we've already won at least *some* CPU if necessary)
+				for (unsigned iThread = 1; iThread < m_threadPool->GetNumThreads(); ++iThread)
+				{
+					if (true == context.threadUsed[iThread])
+					{
+						const float *pSrcL = m_pBufL[iThread];
+						const float *pSrcR = m_pBufR[iThread];
+
+						for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+						{
+							pDestL[iSample] += pSrcL[iSample];
+							pDestR[iSample] += pSrcR[iSample];
+						}
+					}
+				}
+
+				// Calibrate estimates against what we've measured
+				float measured = 0.f, estimated = 0.f;
+				for (auto iVoice : voiceIndices)
 				{
-					auto &saw = voiceOp.oscillator.GetSupersaw();
-					saw.Skip(numSamples);
+					const VoiceCost &cost = m_voiceCosts[iVoice];
+					measured  += cost.timePerSample*cost.numSamples;
+					estimated += cost.estimate*cost.numSamples;
 				}
+
+				if (measured > 0.f && estimated > 0.f)
+					m_timePerCostUnit = lerpf<float>(m_timePerCostUnit, measured/estimated, 0.1f);
 			}
 		}
+		else
+		{
+			// No voices, so just keep up (see RenderModulationBus())
+			m_curLFOBlend.Skip(numSamples);
+			m_curLFOModDepth.Skip(numSamples);
+			m_curCutoff.Skip(numSamples);
+			m_curQ.Skip(numSamples);
+			m_curPitchBend.Skip(numSamples);
+			m_curAmpBend.Skip(numSamples);
+			m_curModulation.Skip(numSamples);
+			m_curAftertouch.Skip(numSamples);
+		}
 
-		// Advance global LFO phase (free running)
-		m_globalLFO->Skip(numSamples);
+		// Advance clock (free running phases catch up on it when needed)
+		m_sampleClock += numSamples;
 				
 		// Update voice logic (post)
 		UpdateVoicesPostRender();
@@ -1955,87 +2726,6 @@ namespace SFM
 		// Update sustain state
 		UpdateSustain();
 
-		// Calc. post filter wetness
-		float postWet = m_patch.postWet;
-		if (Patch::kPostFilter == m_patch.aftertouchMod)
-			postWet = std::min<float>(1.f, postWet+aftertouchFiltered); // More pressure -> more wetness
-
-		// Apply post-processing (FIXME: pass structure?)
-		m_postPass->Apply(numSamples,
-			/* BPM sync. */
-			m_freqBPM, m_patch.syncOverride | overrideDelayBit,
-			/* Auto-wah (FIXME: use more ParameterSlew if necessary) */
-			m_patch.wahResonance,
-			m_patch.wahAttack,
-			m_patch.wahHold,
-			m_patch.wahRate,
-			m_patch.wahDrivedB,
-			m_patch.wahSpeak,
-			m_patch.wahSpeakVowel,
-			m_patch.wahSpeakVowelMod,
-			m_patch.wahSpeakGhost,
-			m_patch.wahSpeakCut,
-			m_patch.wahSpeakResonance,
-			m_patch.wahCut,
-			m_patch.wahWet * ( (Patch::kWahPedal == m_patch.sustainType) ? m_sustain : 1.f ), // FIXME: this ain't great, will probably be noisy without some sort of LPF
-			/* Chorus/Phaser */
-			m_patch.cpRate,
-			m_patch.cpWet,
-			false == m_patch.cpIsPhaser,
-			/* Delay */
-			m_patch.delayInSec,
-			m_patch.delayWet,
-			m_patch.delayDrivedB,
-			m_patch.delayFeedback,
-			m_patch.delayFeedbackCutoff,
-			m_patch.delayTapeWow,
-			/* MOOG-style 24dB filter + Tube distort */
-			m_patch.postCutoff,
-			m_patch.postResonance,
-			m_patch.postDrivedB,
-			postWet,
-			m_patch.tubeDistort,
-			m_patch.tubeDrive,
-			m_patch.tubeOffset,
-			m_patch.tubeTone,
-			m_patch.tubeToneReso,
-			/* Reverb */
-			m_patch.reverbWet,
-			m_patch.reverbRoomSize,
-			m_patch.reverbDampening,
-			m_patch.reverbWidth,
-			m_patch.reverbBassTuningdB,
-			m_patch.reverbTrebleTuningdB,
-			m_patch.reverbPreDelay,
-			/* Compressor */
-			m_patch.compThresholddB,
-			m_patch.compKneedB,
-			m_patch.compRatio,
-			m_patch.compGaindB,
-			m_patch.compAttack,
-			m_patch.compRelease,
-			m_patch.compLookahead,
-			m_patch.compAutoGain,
-			m_patch.compRMSToPeak,
-			/* Tuning (post-EQ) */
-			m_patch.bassTuningdB,
-			m_patch.trebleTuningdB,
-			m_patch.midTuningdB,
-			/* Master volume */
-			m_patch.masterVoldB,
-			/* Buffers */
-			m_pBufL[0], m_pBufR[0], pLeft, pRight);
-
-		// Of all these, copies were used per voice, so skip numSamples to keep up	
-		m_curLFOBlend.Skip(numSamples);
-		m_curLFOModDepth.Skip(numSamples);
-		m_curCutoff.Skip(numSamples);
-		m_curQ.Skip(numSamples);
-		m_curPitchBend.Skip(numSamples);
-		m_curAmpBend.Skip(numSamples);
-		m_curModulation.Skip(numSamples);
-		m_curAftertouch.Skip(numSamples);
-
 		// This has been done by now
 		m_resetVoices   = false;
 		m_resetPhaseBPM = false;
@@ -2074,4 +2764,86 @@ namespace SFM
 		}
 	}
 
+	// Called once per Render() (after all voices have been rendered into m_pBufL[0] & m_pBufR[0])
+	void Bison::ApplyPostPass(unsigned numSamples, float *pLeft, float *pRight)
+	{
+		SFM_ASSERT(numSamples > 0 && numSamples <= m_samplesPerBlock);
+
+		// If can't fit delay within it's line, revert to manual setting
+		unsigned overrideDelayBit = 0;
+		if (0.f != m_freqBPM && 1.f/m_freqBPM >= kMainDelayInSec)
+			overrideDelayBit = kFlagOverrideDelay;
+
+		// Calc. post filter wetness
+		float postWet = m_pPatch->postWet;
+		if (Patch::kPostFilter == m_pPatch->aftertouchMod)
+			postWet = std::min<float>(1.f, postWet+m_curAftertouch.GetTarget()); // More pressure -> more wetness
+
+		// Apply post-processing (FIXME: pass structure?)
+		m_postPass->Apply(numSamples,
+			/* BPM sync. */
+			m_freqBPM, m_pPatch->syncOverride | overrideDelayBit,
+			/* Auto-wah (FIXME: use more ParameterSlew if necessary) */
+			m_pPatch->wahResonance,
+			m_pPatch->wahAttack,
+			m_pPatch->wahHold,
+			m_pPatch->wahRate,
+			m_pPatch->wahDrivedB,
+			m_pPatch->wahSpeak,
+			m_pPatch->wahSpeakVowel,
+			m_pPatch->wahSpeakVowelMod,
+			m_pPatch->wahSpeakGhost,
+			m_pPatch->wahSpeakCut,
+			m_pPatch->wahSpeakResonance,
+			m_pPatch->wahCut,
+			m_pPatch->wahWet * ( (Patch::kWahPedal == m_pPatch->sustainType) ? m_sustain : 1.f ), // FIXME: this ain't great, will probably be noisy without some sort of LPF
+			/* Chorus/Phaser */
+			m_pPatch->cpRate,
+			m_pPatch->cpWet,
+			false == m_pPatch->cpIsPhaser,
+			/* Delay */
+			m_pPatch->delayInSec,
+			m_pPatch->delayWet,
+			m_pPatch->delayDrivedB,
+			m_pPatch->delayFeedback,
+			m_pPatch->delayFeedbackCutoff,
+			m_pPatch->delayTapeWow,
+			/* MOOG-style 24dB filter + Tube distort */
+			m_pPatch->postCutoff,
+			m_pPatch->postResonance,
+			m_pPatch->postDrivedB,
+			postWet,
+			m_pPatch->tubeDistort,
+			m_pPatch->tubeDrive,
+			m_pPatch->tubeOffset,
+			m_pPatch->tubeTone,
+			m_pPatch->tubeToneReso,
+			/* Reverb */
+			m_pPatch->reverbWet,
+			m_pPatch->reverbRoomSize,
+			m_pPatch->reverbDampening,
+			m_pPatch->reverbWidth,
+			m_pPatch->reverbBassTuningdB,
+			m_pPatch->reverbTrebleTuningdB,
+			m_pPatch->reverbPreDelay,
+			/* Compressor */
+			m_pPatch->compThresholddB,
+			m_pPatch->compKneedB,
+			m_pPatch->compRatio,
+			m_pPatch->compGaindB,
+			m_pPatch->compAttack,
+			m_pPatch->compRelease,
+			m_pPatch->compLookahead,
+			m_pPatch->compAutoGain,
+			m_pPatch->compRMSToPeak,
+			/* Tuning (post-EQ) */
+			m_pPatch->bassTuningdB,
+			m_pPatch->trebleTuningdB,
+			m_pPatch->midTuningdB,
+			/* Master volume */
+			m_pPatch->masterVoldB,
+			/* Buffers */
+			m_pBufL[0], m_pBufR[0], pLeft, pRight);
+	}
+
 }; // namespace SFM
@@ -42,7 +42,7 @@
 	- TinyMT Mersenne-Twister random generator by Makoto Matsumoto and Mutsuo Saito 
 	- Yamaha DX7 LFO rates (synth-DX7-LFO-table.h) taken from Sean Bolton's Hexter
 	- Fast cosine approximation supplied by Erik 'Kusma' Faye-Lund
-	- There are 2 dependencies on JUCE (currently these have little priority as we use JUCE for our product line)
+	- The only remaining dependencies on JUCE are jassert() (SFM_ASSERT(), debug builds) and DBG() (Log())
 	- 'PolyBLEP'-based oscillators were lifted from https://github.com/martinfinke/PolyBLEP; by various authors (I keep a ref. copy in /3rdparty)
 	- I've ported a lot of interpolation functions from http://easings.net to single prec.
 	- *Big* thank you Adam Szabo for his thesis on the JP-8000 supersaw: https://pdfs.semanticscholar.org/1852/250068e864215dd7f12755cf00636868a251.pdf 
@@ -57,7 +57,7 @@
 		- Subtractive synthesis (filters & effects) on top
 		- Goal: low CPU footprint in DAWs, possibly embedded targets in the future
 
-	This library is *not* thread-safe!
+	This library is *not* thread-safe, save for posting events (see Bison::Post*()) & publishing patches (see Bison::PublishPatch())!
  
 	Issues:
 		- I've spotted some potentially overzealous and inconsistent use of SFM_INLINE (29/05/2020)
@@ -75,14 +75,13 @@
 
 #pragma once
 
-#include <thread>
-
 #include "synth-global.h"
 
 #include "patch/synth-patch-global.h"
 #include "synth-post-pass.h"
 #include "synth-phase.h"
 #include "synth-voice.h"
+#include "synth-thread-pool.h"
 
 namespace SFM
 {
@@ -103,7 +102,9 @@ namespace SFM
 		//
 		
 		// Handles global initialization & release
-		Bison();
+		// 'numVoiceThreads' - number of worker threads (on top of the calling one) used to render voices, by default the number of cores minus one;
+		//                     zero renders all voices on the calling thread (see MultiTimbral, which runs whole instances on it's own pool)
+		Bison(unsigned numVoiceThreads = kAutoNumWorkers);
 		~Bison();
 
 		// Called by JUCE's prepareToPlay()
@@ -113,12 +114,22 @@ namespace SFM
 		// Releases everything set by OnSetSamplingProperties()
 		void DeleteRateDependentObjects();
 
-		// Access to patch (or preset, if you will); never access during Render(), if so, fix by double-buffering
+		/*
+			Access to patch (or preset, if you will), this is the writer's copy: change it at will, from (one) thread 
+			other than the one that calls Render() if need be, and call PublishPatch() to hand it to Render()
+
+			- Publishing is wait-free, Render() picks up the latest published patch at the start of each call
+			- Changes that aren't published are not heard
+			- Do *not* edit or publish from different threads at the same time
+		*/
+
 		Patch& GetPatch()
 		{
-			return m_patch;
+			return m_editPatch;
 		}
 
+		void PublishPatch();
+
 		void ResetVoices()
 		{
 			// Reset (i.e. quickly fade) all voices on next Render() call
@@ -133,9 +144,29 @@ namespace SFM
 				// Create a new instance, that way we won't have to fiddle with details
 				// However, do *not* call this often while rendering
 				delete m_postPass;
-				m_postPass = new PostPass(m_sampleRate, m_samplesPerBlock, m_Nyquist);
+				m_postPass = new PostPass(m_sampleRate, m_samplesPerBlock, m_Nyquist, m_postOversamplingStages, m_postOversamplingDesign);
 			}
 		}
+
+		// Oversampling of tube distortion & post filter: 0 (1X) to kMaxOversamplingStages (8X) stages, FIR (linear
+		// phase) or IIR (minimal latency); resets the post-pass, so do *not* call this often while rendering
+		// Latency changes accordingly (see GetLatency())
+		void SetPostOversampling(unsigned numStages, Oversampler::Design design)
+		{
+			SFM_ASSERT(numStages <= kMaxOversamplingStages);
+
+			m_postOversamplingStages = std::min<unsigned>(numStages, kMaxOversamplingStages);
+			m_postOversamplingDesign = design;
+
+			ResetPostPass();
+		}
+
+		// Implementation of band-limited operator waveforms, PolyBLEP or (mip-mapped) wavetables (see synth-wavetable.h)
+		// Takes effect on the next note
+		void SetOperatorEngine(Oscillator::Engine engine)
+		{
+			m_operatorEngine = engine;
+		}
 		
 		// Render number of samples to 2 channels (stereo)
 		// 'bendWheel'  - amount of pitch bend (wheel) [-1..1]
@@ -150,12 +181,13 @@ namespace SFM
 
 			if (m_BPM != BPM)
 			{
-				Log("Host has set new BPM: " + std::to_string(BPM));
+				Log("Host has set new BPM: %f", BPM);
 				m_BPM = BPM;
 			}
 		}
 
 		// Note events (just to be sure: do *not* call these from different threads!)
+		// These are scheduled and take effect at their time stamp during the next Render() call(s) (see SetEventGrid())
 		void NoteOn(
 			unsigned key, 
 			float frequency,               // Uses internal table if -1.f
@@ -164,12 +196,65 @@ namespace SFM
 
 		void NoteOff(unsigned key, unsigned timeStamp);
 		
-		// Apply sustain to (active) voices
-		void Sustain(bool state)
+		// Apply sustain to (active) voices (scheduled, like the note events)
+		void Sustain(bool state, unsigned timeStamp = 0)
+		{
+			ScheduleEvent({ Event::kSustain, timeStamp, 0, 0.f, 0.f, state });
+		}
+
+		// Render() splits blocks at the time stamps of scheduled events (note-offs, sustain & controllers) rounded down to 
+		// a multiple of this grid (in samples), so 1 is sample-accurate and larger values limit the number of splits;
+		// voices are always started at their exact time stamp
+		void SetEventGrid(unsigned numSamples)
+		{
+			SFM_ASSERT(numSamples > 0);
+			m_eventGrid = std::max<unsigned>(1, numSamples);
+		}
+
+		// Main (voice) filter coefficients are calculated every 'numSamples' and interpolated in between (see synth-control-rate-SVF.h)
+		// 1 calculates them every sample (if they change)
+		void SetFilterControlRate(unsigned numSamples)
+		{
+			SFM_ASSERT(numSamples > 0);
+			m_filterControlRate = std::max<unsigned>(1, numSamples);
+		}
+
+		// Once there are no voices, all effect tails have died out and the output has stayed below 'floordB' for 'numBlocks'
+		// Render() calls, Render() goes to sleep: it outputs silence and only keeps free running phases in pace until an event
+		// is due; zero blocks disables this
+		void SetSleep(float floordB, unsigned numBlocks)
+		{
+			SFM_ASSERT(floordB <= 0.f);
+
+			m_sleepFloor = dB2Lin(floordB);
+			m_sleepNumBlocks = numBlocks;
+		}
+
+		bool IsAsleep() const
 		{
-			m_sustain = state;
+			return m_isAsleep;
 		}
 
+		/*
+			Events, these are thread-safe (wait-free) and can be posted from a single thread other than the one that calls 
+			Render(), say a network MIDI thread, without a lock; Render() drains them at the start of each block
+
+			- Time stamps work like they do for NoteOn() & NoteOff(), so these are sample-accurate as well
+			- Returns false if the queue is full (kMaxEvents), in which case the event is dropped
+			- Controller values (bend, modulation & aftertouch) are used by the Render() overload that does not take them
+		*/
+
+		bool PostNoteOn(unsigned key, float frequency, float velocity, unsigned timeStamp);
+		bool PostNoteOff(unsigned key, unsigned timeStamp);
+		bool PostSustain(bool state, unsigned timeStamp);
+		bool PostPitchBend(float bendWheel, unsigned timeStamp);  // [-1..1]
+		bool PostModulation(float modulation, unsigned timeStamp); // [0..1]
+		bool PostAftertouch(float aftertouch, unsigned timeStamp); // [0..1]
+		bool PostBPM(float BPM, bool resetPhase);
+
+		// Render number of samples to 2 channels (stereo) using controller values posted as events
+		void Render(unsigned numSamples, float *pLeft, float *pRight);
+
 		unsigned GetSampleRate() const      { return m_sampleRate;      }
 		unsigned GetSamplesPerBlock() const { return m_samplesPerBlock; }
 		unsigned GetNyquist() const         { return m_Nyquist;         }
@@ -232,6 +317,107 @@ namespace SFM
 
 		typedef unsigned VoiceReleaseRequest; // Simply a MIDI key (n0umber)
 
+		/*
+			Events (see Post*())
+		*/
+
+		static constexpr unsigned kMaxEvents = 1024;
+
+		struct Event
+		{
+			enum Type
+			{
+				kNoteOn,
+				kNoteOff,
+				kSustain,
+				kPitchBend,
+				kModulation,
+				kAftertouch,
+				kBPM
+			};
+
+			Type type;
+			unsigned timeStamp;
+			unsigned key;
+			float value;    // Frequency, controller value or BPM
+			float velocity;
+			bool state;     // Sustain or BPM phase reset
+		};
+
+		SFM_INLINE bool PostEvent(Event::Type type, unsigned timeStamp, unsigned key, float value, float velocity, bool state)
+		{
+			const Event event = { type, timeStamp, key, value, velocity, state };
+			return m_events.Push(event);
+		}
+
+		// Adds event to schedule (sorted by time stamp, events with equal ones keep their order)
+		void ScheduleEvent(const Event &event);
+
+		// Moves posted events to schedule (called by Render())
+		void DrainEvents();
+
+		// Handles event immediately
+		void ApplyEvent(const Event &event, unsigned offset);
+
+		/*
+			Patch snapshots (see PublishPatch())
+		*/
+
+		// Sections of the patch that are tracked individually
+		enum PatchSection
+		{
+			kPatchOperators, // Patch::operators
+			kPatchGlobals,   // Everything else
+			kNumPatchSections
+		};
+
+		struct PatchSnapshot
+		{
+			Patch patch;
+			
+			// Bumped each time the section changed on publish, zero means never published
+			unsigned generation[kNumPatchSections] = { 0 };
+		};
+
+		// Picks up latest published patch (render thread, but also called by OnSetSamplingProperties())
+		void UpdatePatch();
+
+		// Last published snapshot (writer only), used to tell which sections changed
+		PatchSnapshot m_published;
+
+		// Published snapshots
+		TripleBuffer<PatchSnapshot> m_patches;
+
+		// Note events (see NoteOn() & NoteOff())
+		void OnNoteOn(unsigned key, float frequency, float velocity, unsigned timeStamp);
+		void OnNoteOff(unsigned key, unsigned timeStamp);
+
+		// Posted events
+		SPSCRingBuffer<Event, kMaxEvents> m_events;
+
+		// Events yet to be handled (render thread only), time stamps relative to next Render() call
+		FixedVector<Event, kMaxEvents> m_schedule;
+		unsigned m_eventGrid = kDefEventGrid;
+
+		// See SetFilterControlRate()
+		unsigned m_filterControlRate = kDefFilterControlRate;
+
+		// Set if sustain state changed, so UpdateSustain() can be called right away
+		bool m_sustainChanged = false;
+
+		// Last controller values received through events
+		float m_eventBendWheel  = 0.f;
+		float m_eventModulation = 0.f;
+		float m_eventAftertouch = 0.f;
+
+		// Sleep (see SetSleep())
+		float m_sleepFloor = dB2Lin(kDefSleepFloordB);
+		unsigned m_sleepNumBlocks = kDefSleepNumBlocks;
+		unsigned m_numSilentBlocks = 0;
+		bool m_isAsleep = false;
+		bool m_isWaking = false;
+		uint64_t m_numSleptSamples = 0; // Yet to be skipped by the post-pass' free running phases
+
 		struct MonoVoiceReleaseRequest
 		{
 			VoiceReleaseRequest key;
@@ -296,7 +482,7 @@ namespace SFM
 				InitializeMonoVoice(m_monoVoiceReq);
 			}
 			
-			Log("Voice triggered: " + std::to_string(iVoice) + ", key: " + std::to_string(m_voices[iVoice].m_key));
+			Log("Voice triggered: %u, key: %d", iVoice, m_voices[iVoice].m_key);
 		}
 
 		// Called by Render()
@@ -304,6 +490,46 @@ namespace SFM
 		void UpdateVoicesPostRender();
 		void UpdateSustain();
 
+		// Splits block at scheduled events, 'eventControllers' selects bend, modulation & aftertouch posted as events over those passed
+		void RenderScheduled(unsigned numSamples, bool eventControllers, float bendWheel, float modulation, float aftertouch, float *pLeft, float *pRight);
+
+		// Renders voices for part of a block (as is) into m_pBufL[0] & m_pBufR[0], starting at 'offset'
+		void RenderBlock(unsigned offset, unsigned numSamples, float bendWheel, float modulation, float aftertouch);
+
+		// Applies post-pass to m_pBufL[0] & m_pBufR[0] (entire block)
+		void ApplyPostPass(unsigned numSamples, float *pLeft, float *pRight);
+
+		// Free running phases (supersaws of voices & operators not in use, global LFO) are only brought up to date
+		// with m_sampleClock when they're needed
+		SFM_INLINE void ResumeSupersaw(Voice::Operator &voiceOp)
+		{
+			Supersaw &supersaw = voiceOp.oscillator.GetSupersaw();
+
+			if (true == voiceOp.enabled)
+				supersaw.Resume(m_sampleClock);
+			else
+				supersaw.Free(m_sampleClock);
+		}
+
+		SFM_INLINE void CatchUpGlobalLFO()
+		{
+			m_globalLFO->Skip(m_sampleClock-m_globalLFOClock);
+			m_globalLFOClock = m_sampleClock;
+		}
+
+		SFM_INLINE void SetGlobalLFOFrequency(float frequency)
+		{
+			if (frequency != m_globalLFO->GetFrequency())
+			{
+				CatchUpGlobalLFO();
+				m_globalLFO->SetFrequency(frequency);
+			}
+		}
+
+		// Catches up on slept samples (see SetSleep())
+		void SkipSlept();
+		void Wake();
+
 		// Parameters for each voice to be rendered
 		struct VoiceRenderParameters
 		{
@@ -319,23 +545,62 @@ namespace SFM
 			float mainFilterAftertouch;
 		};
 
+		// Global parameters per sample, rendered once per block by RenderModulationBus(); voices only read them
+		struct ModulationBus
+		{
+			float *pAftertouch;
+			float *pModulation;  // Aftertouch applied (see VoiceRenderParameters)
+			float *pPitchBend;   // [-1..1]
+			float *pAmpBend;     // Gain
+			float *pLFOBlend;
+			float *pLFOModDepth;
+			float *pCutoff;      // In Hz, aftertouch applied (not the envelope), only rendered if there's a main filter
+			float *pQ;           // Only rendered if there's a main filter
+
+			// Pitch bend multiplier (see CalcPitchBendMul()), only rendered for bend ranges used by a voice this block
+			float *pPitchBendMul[kMaxPitchBendRange+1];
+		};
+
+		static constexpr unsigned kNumModulationBusBuffers = 8 + kMaxPitchBendRange+1;
+
 		// Voice thread basics (parameters, indices, buffers)
+		// Voices rendered by a single job: 'pVoiceIndices[first..first+count-1]' (more than 1 means they're rendered in lanes, see synth-voice-lanes.h)
+		struct VoiceJob
+		{
+			unsigned first;
+			unsigned count;
+		};
+
 		struct VoiceThreadContext
 		{
-			VoiceThreadContext(const VoiceRenderParameters &parameters) :
-				parameters(parameters) {}
+			VoiceThreadContext(Bison *pInst, const VoiceRenderParameters &parameters) :
+				pInst(pInst), parameters(parameters) {}
 
+			Bison *pInst;
 			const VoiceRenderParameters &parameters;
 			
-			std::vector<unsigned> voiceIndices;
-
+			const unsigned *pVoiceIndices = nullptr;
+			const VoiceJob *pJobs = nullptr;
 			unsigned numSamples = 0;
-			float *pDestL = nullptr;
-			float *pDestR = nullptr;
+
+			// Set by each thread once it's cleared it's own intermediate buffers (thread 0 renders to the main ones)
+			bool threadUsed[kMaxPoolThreads] = { true };
 		};
 
-		static void VoiceRenderThread(Bison *pInst, VoiceThreadContext *pContext);
-		void RenderVoices(const VoiceRenderParameters &context, const std::vector<unsigned> &voiceIndices, unsigned numSamples, float *pDestL, float *pDestR) const;
+		// Thread pool job: renders a single voice or group (one of 'pJobs') to the intermediate buffers of the thread it runs on
+		static void VoiceRenderThread(void *pContext, unsigned iJob, unsigned iThread);
+
+		// Returns number of voices, starting at the first index, that can be rendered in lanes (1 if none)
+		unsigned GetNumVoiceLanes(const unsigned *pVoiceIndices, unsigned numVoices) const;
+
+		// Indices of voices to render (see Render())
+		typedef FixedVector<unsigned, kMaxPolyVoices> VoiceIndices;
+
+		void RenderModulationBus(const VoiceRenderParameters &context, const VoiceIndices &voiceIndices, unsigned numSamples);
+		void RenderVoices(const VoiceRenderParameters &context, const VoiceIndices &voiceIndices, unsigned numSamples, float *pDestL, float *pDestR) const;
+		void PrepareVoice(const VoiceRenderParameters &context, Voice &voice) const;
+		void RenderVoice(const VoiceRenderParameters &context, unsigned iVoice, unsigned numSamples, float *pDestL, float *pDestR) const;
+		void RenderVoiceLanes(const VoiceRenderParameters &context, const unsigned *pVoiceIndices, unsigned numVoices, unsigned numSamples, float *pDestL, float *pDestR) const;
 
 		/*
 			Variables.
@@ -346,8 +611,12 @@ namespace SFM
 		unsigned m_Nyquist;
 		unsigned m_samplesPerBlock;
 
-		// Parameters (patch)
-		Patch m_patch;
+		// Parameters (patch): the writer's copy (see GetPatch()) & the snapshot Render() uses
+		Patch m_editPatch;
+		const Patch *m_pPatch = nullptr;
+
+		// Generation of each section of the current snapshot
+		unsigned m_patchGen[kNumPatchSections] = { 0 };
 
 		float m_BPM;          // Current BPM (if any)
 		float m_freqBPM;      // Current BPM ratio-adjusted frequency (updated in Render())
@@ -360,14 +629,14 @@ namespace SFM
 		bool m_modeSwitch;
 		Patch::VoiceMode m_curVoiceMode;
 
-		// Polyphonic requests
-		std::deque<VoiceRequest> m_polyVoiceReq;
-		std::deque<VoiceReleaseRequest> m_polyVoiceReleaseReq;
+		// Polyphonic requests (fixed capacity so that NoteOn(), NoteOff() & Render() never allocate)
+		FixedVector<VoiceRequest, kMaxPolyVoices> m_polyVoiceReq;
+		FixedVector<VoiceReleaseRequest, kMIDINumKeys> m_polyVoiceReleaseReq;
 
 		// Monophonic requests
-		std::deque<VoiceRequest> m_monoSequence;       // All pressed keys (including ones not triggered) are tracked
-		VoiceRequest m_monoVoiceReq;                   // This frame's request; if 'key' is kInvalid, there is none
-		MonoVoiceReleaseRequest m_monoVoiceReleaseReq; // Same, but for, you guessed it, release
+		FixedVector<VoiceRequest, kMIDINumKeys> m_monoSequence; // All pressed keys (including ones not triggered) are tracked
+		VoiceRequest m_monoVoiceReq;                            // This frame's request; if 'key' is kInvalid, there is none
+		MonoVoiceReleaseRequest m_monoVoiceReleaseReq;          // Same, but for, you guessed it, release
 
 		// Sustain?
 		bool m_sustain;
@@ -386,16 +655,44 @@ namespace SFM
 	
 		// Effects
 		PostPass *m_postPass = nullptr;
+		unsigned m_postOversamplingStages = kDefPostOversamplingStages;
+		Oversampler::Design m_postOversamplingDesign = kDefPostOversamplingDesign;
+
+		// Band-limited operator waveforms (see SetOperatorEngine())
+		Oscillator::Engine m_operatorEngine = kDefOperatorEngine;
 
-		// Running LFO (used for no key sync.)
+		// Running LFO (used for no key sync.), it's phase is that of m_globalLFOClock
 		Phase *m_globalLFO = nullptr;
+		uint64_t m_globalLFOClock = 0;
+
+		// Number of samples rendered (or slept) since construction
+		uint64_t m_sampleClock = 0;
 
 		// Necessary to reset filter on type switch
 		SvfLinearTrapOptimised2::FLT_TYPE m_curFilterType; 
 
-		// Intermediate buffers
-		float *m_pBufL[2] = { nullptr, nullptr };
-		float *m_pBufR[2] = { nullptr, nullptr };
+		// Voice render workers (nullptr if SFM_DISABLE_VOICE_THREAD is defined)
+		ThreadPool *m_threadPool = nullptr;
+
+		// Voice render cost, used to balance voices across render threads (see Render())
+		struct VoiceCost
+		{
+			float estimate;      // Estimated cost per sample (see EstimateVoiceCost() in FM_BISON.cpp)
+			float timePerSample; // Measured time (nanoseconds) per sample in previous block(s), zero if unknown
+			float expected;      // Expected time (nanoseconds) for current block
+			unsigned numSamples; // Number of samples actually rendered in current block (i.e. minus offset)
+		};
+
+		VoiceCost m_voiceCosts[kMaxPolyVoices];
+		float m_timePerCostUnit; // Calibrates estimates against measurements (nanoseconds)
+
+		// Intermediate buffers (a pair for each render thread, first pair is the main mix)
+		float *m_pBufL[kMaxPoolThreads] = { nullptr };
+		float *m_pBufR[kMaxPoolThreads] = { nullptr };
+
+		// Modulation bus (buffers are part of a single allocation)
+		ModulationBus m_modBus;
+		float *m_pModBusBuf = nullptr;
 
 		alignas(16) Voice m_voices[kMaxPolyVoices];       // Array of voices to use
 		alignas(16) bool  m_voicesStolen[kMaxPolyVoices]; // Simple way to flag voices as stolen; contain related logic in FM_BISON.cpp
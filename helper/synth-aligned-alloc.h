@@ -9,6 +9,8 @@
 
 #include <stdlib.h>
 
+#include "synth-allocation-guard.h"
+
 namespace SFM
 {
 	inline void* mallocAligned(size_t size, size_t align);
@@ -16,13 +18,15 @@ namespace SFM
 
 #ifdef _WIN32
 
-	__forceinline void* mallocAligned(size_t size, size_t align) { return _aligned_malloc(size, align); }
+	__forceinline void* mallocAligned(size_t size, size_t align) { OnAllocation(size); return _aligned_malloc(size, align); }
 	__forceinline void  freeAligned(void* address) { _aligned_free(address); }
 
 #elif defined(__GNUC__)
 
 	inline void* mallocAligned(size_t size, size_t align) 
 	{ 
+		OnAllocation(size);
+
 		void* address;
 		posix_memalign(&address, align, size);
 		return address;
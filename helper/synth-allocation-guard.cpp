@@ -0,0 +1,113 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Allocation guard (test mode to verify Render() is allocation-free).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include "../synth-global.h"
+#include "synth-allocation-guard.h"
+
+#if defined(SFM_DETECT_RENDER_ALLOCATIONS)
+
+#include <new>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace SFM
+{
+	// Depth of NoAllocationScope on current thread
+	static thread_local unsigned s_scopeDepth = 0;
+
+	static std::atomic<unsigned> s_numAllocations(0);
+
+	void OnAllocation(size_t size)
+	{
+		if (0 == s_scopeDepth)
+			return;
+
+		++s_numAllocations;
+
+		// Don't allocate while reporting
+		s_scopeDepth = 0;
+
+		fprintf(stderr, "FM. BISON: allocation of %u byte(s) inside Render()\n", unsigned(size));
+		fflush(stderr);
+
+		SFM_ASSERT(false);
+		abort();
+	}
+
+	unsigned GetNumRenderAllocations()
+	{
+		return s_numAllocations.load();
+	}
+
+	NoAllocationScope::NoAllocationScope()
+	{
+		++s_scopeDepth;
+	}
+
+	NoAllocationScope::~NoAllocationScope()
+	{
+		SFM_ASSERT(s_scopeDepth > 0);
+		--s_scopeDepth;
+	}
+
+	AllowAllocationScope::AllowAllocationScope() :
+		m_depth(s_scopeDepth)
+	{
+		s_scopeDepth = 0;
+	}
+
+	AllowAllocationScope::~AllowAllocationScope()
+	{
+		s_scopeDepth = m_depth;
+	}
+}
+
+/*
+	Global operator new & delete replacements (only the allocating side reports)
+*/
+
+static void *AllocateOrThrow(size_t size)
+{
+	SFM::OnAllocation(size);
+
+	void *address = malloc((0 != size) ? size : 1);
+	if (nullptr == address)
+		throw std::bad_alloc();
+
+	return address;
+}
+
+static void *AllocateAlignedOrThrow(size_t size, std::align_val_t align)
+{
+	// Reported by mallocAligned()
+	void *address = SFM::mallocAligned((0 != size) ? size : 1, size_t(align));
+	if (nullptr == address)
+		throw std::bad_alloc();
+
+	return address;
+}
+
+void *operator new(size_t size)                                                     { return AllocateOrThrow(size); }
+void *operator new[](size_t size)                                                   { return AllocateOrThrow(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept                    { SFM::OnAllocation(size); return malloc((0 != size) ? size : 1); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept                  { SFM::OnAllocation(size); return malloc((0 != size) ? size : 1); }
+void *operator new(size_t size, std::align_val_t align)                             { return AllocateAlignedOrThrow(size, align); }
+void *operator new[](size_t size, std::align_val_t align)                           { return AllocateAlignedOrThrow(size, align); }
+
+void operator delete(void *address) noexcept                                        { free(address); }
+void operator delete[](void *address) noexcept                                      { free(address); }
+void operator delete(void *address, size_t) noexcept                                { free(address); }
+void operator delete[](void *address, size_t) noexcept                              { free(address); }
+void operator delete(void *address, const std::nothrow_t &) noexcept                { free(address); }
+void operator delete[](void *address, const std::nothrow_t &) noexcept              { free(address); }
+void operator delete(void *address, std::align_val_t) noexcept                      { SFM::freeAligned(address); }
+void operator delete[](void *address, std::align_val_t) noexcept                    { SFM::freeAligned(address); }
+void operator delete(void *address, size_t, std::align_val_t) noexcept              { SFM::freeAligned(address); }
+void operator delete[](void *address, size_t, std::align_val_t) noexcept            { SFM::freeAligned(address); }
+
+#endif // SFM_DETECT_RENDER_ALLOCATIONS
@@ -0,0 +1,68 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Allocation guard (test mode to verify Render() is allocation-free).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Define SFM_DETECT_RENDER_ALLOCATIONS (see synth-global.h) to replace global operator new (all variants) and have
+	mallocAligned() report to this guard; any allocation made on a thread while it's inside a NoAllocationScope is
+	reported on stderr after which the process is aborted, so a host (or test) running a session will fail loudly.
+
+	- Scopes are per thread; Render() opens one on the calling thread and each voice render job on the pool's threads
+	- Plain malloc() is not hooked, the engine itself only calls it through mallocAligned()
+	- Debug logging (synth-log.cpp) is exempt, it's compiled out of release builds anyway
+	- Without SFM_DETECT_RENDER_ALLOCATIONS all of this compiles to nothing
+*/
+
+#pragma once
+
+// Included by synth-aligned-alloc.h, so this one's self-contained
+#include <cstddef>
+
+namespace SFM
+{
+#if defined(SFM_DETECT_RENDER_ALLOCATIONS)
+
+	// Called by all hooked allocation functions
+	void OnAllocation(size_t size);
+
+	// Number of allocations detected (always zero unless the process is about to abort)
+	unsigned GetNumRenderAllocations();
+
+	class NoAllocationScope
+	{
+	public:
+		NoAllocationScope();
+		~NoAllocationScope();
+	};
+
+	// Temporarily lifts the current scope (if any), strictly for debug-only code paths
+	class AllowAllocationScope
+	{
+	public:
+		AllowAllocationScope();
+		~AllowAllocationScope();
+
+	private:
+		unsigned m_depth;
+	};
+
+#else
+
+	inline void OnAllocation(size_t) {}
+	inline unsigned GetNumRenderAllocations() { return 0; }
+
+	class NoAllocationScope
+	{
+	public:
+		inline NoAllocationScope() {}
+	};
+
+	class AllowAllocationScope
+	{
+	public:
+		inline AllowAllocationScope() {}
+	};
+
+#endif
+}
@@ -0,0 +1,114 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Fixed capacity vector (never allocates, for use on the audio thread).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	A drop-in for the handful of std::vector & std::deque functions used by Render() and the NoteOn()/NoteOff() path;
+	storage is part of the object, so size it from known limits (kMaxPolyVoices, kMIDINumKeys) and assert on overflow.
+
+	- Elements are contiguous, iterators are plain pointers (so std::sort() & friends work)
+	- Front insertion & erasure move the remaining elements (fine for the sizes we deal with)
+	- Only meant for trivial types (requests, indices)
+*/
+
+#pragma once
+
+#include <type_traits>
+
+#include "../synth-global.h"
+
+namespace SFM
+{
+	template<typename T, unsigned kCapacity> class FixedVector
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "FixedVector is meant for trivial types only");
+
+	public:
+		typedef T* iterator;
+		typedef const T* const_iterator;
+
+		SFM_INLINE unsigned size() const     { return m_size;         }
+		SFM_INLINE bool empty() const        { return 0 == m_size;    }
+		SFM_INLINE bool full() const         { return kCapacity == m_size; }
+		SFM_INLINE unsigned capacity() const { return kCapacity;      }
+
+		SFM_INLINE void clear()
+		{
+			m_size = 0;
+		}
+
+		SFM_INLINE void push_back(const T &element)
+		{
+			SFM_ASSERT(false == full());
+			m_elements[m_size++] = element;
+		}
+
+		SFM_INLINE void emplace_back(const T &element)
+		{
+			push_back(element);
+		}
+
+		SFM_INLINE void emplace_front(const T &element)
+		{
+			SFM_ASSERT(false == full());
+			memmove(m_elements+1, m_elements, m_size*sizeof(T));
+			m_elements[0] = element;
+			++m_size;
+		}
+
+		SFM_INLINE void pop_back()
+		{
+			SFM_ASSERT(false == empty());
+			--m_size;
+		}
+
+		SFM_INLINE void pop_front()
+		{
+			erase(begin());
+		}
+
+		SFM_INLINE iterator erase(iterator iElement)
+		{
+			return erase(iElement, iElement+1);
+		}
+
+		SFM_INLINE iterator erase(iterator iFirst, iterator iLast)
+		{
+			SFM_ASSERT(iFirst >= begin() && iFirst <= iLast && iLast <= end());
+			memmove(iFirst, iLast, (end()-iLast)*sizeof(T));
+			m_size -= unsigned(iLast-iFirst);
+			return iFirst;
+		}
+
+		SFM_INLINE iterator insert(iterator iPos, const T &element)
+		{
+			SFM_ASSERT(false == full());
+			SFM_ASSERT(iPos >= begin() && iPos <= end());
+			memmove(iPos+1, iPos, (end()-iPos)*sizeof(T));
+			*iPos = element;
+			++m_size;
+			return iPos;
+		}
+
+		SFM_INLINE T &front()             { SFM_ASSERT(false == empty()); return m_elements[0];        }
+		SFM_INLINE const T &front() const { SFM_ASSERT(false == empty()); return m_elements[0];        }
+		SFM_INLINE T &back()              { SFM_ASSERT(false == empty()); return m_elements[m_size-1]; }
+		SFM_INLINE const T &back() const  { SFM_ASSERT(false == empty()); return m_elements[m_size-1]; }
+
+		SFM_INLINE T &operator[](unsigned index)             { SFM_ASSERT(index < m_size); return m_elements[index]; }
+		SFM_INLINE const T &operator[](unsigned index) const { SFM_ASSERT(index < m_size); return m_elements[index]; }
+
+		SFM_INLINE T *data()             { return m_elements; }
+		SFM_INLINE const T *data() const { return m_elements; }
+
+		SFM_INLINE iterator begin()             { return m_elements;        }
+		SFM_INLINE iterator end()               { return m_elements+m_size; }
+		SFM_INLINE const_iterator begin() const { return m_elements;        }
+		SFM_INLINE const_iterator end() const   { return m_elements+m_size; }
+
+	private:
+		T m_elements[kCapacity];
+		unsigned m_size = 0;
+	};
+}
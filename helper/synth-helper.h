@@ -120,6 +120,16 @@ namespace SFM
 		return std::max<float>(fabsf(sampleL), fabsf(sampleR));
 	}
 
+	// Same, for an entire block (peak)
+	SFM_INLINE static float GetRectifiedMaximum(const float *pLeft, const float *pRight, unsigned numSamples)
+	{
+		float peak = 0.f;
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			peak = std::max<float>(peak, GetRectifiedMaximum(pLeft[iSample], pRight[iSample]));
+
+		return peak;
+	}
+
 	/* ----------------------------------------------------------------------------------------------------
 
 		Integrity checks/assertions.
@@ -5,6 +5,9 @@
 	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
 */
 
+#include <cstdarg>
+#include <cstdio>
+
 #include "synth-log.h"
 
 namespace SFM
@@ -12,14 +15,25 @@ namespace SFM
 
 #if SFM_NO_LOGGING // Set in synth-global.h
 
-	void Log(const std::string &message) {}
+	void Log(const char *, ...) {}
 
 #else
 
-	void Log(const std::string &message)
+	// Longer messages are truncated
+	constexpr size_t kMaxLogLength = 256;
+
+	void Log(const char *format, ...)
 	{
-		// JUCE output
-		DBG(message.c_str());
+		char message[kMaxLogLength];
+
+		va_list args;
+		va_start(args, format);
+		vsnprintf(message, kMaxLogLength, format, args);
+		va_end(args);
+
+		// JUCE output (allocates, but this is debug only)
+		AllowAllocationScope allowAllocation;
+		DBG(message);
 	}
 
 #endif // SFM_NO_LOGGING
@@ -1,17 +1,17 @@
-
 /*
 	FM. BISON hybrid FM synthesis -- Debug logging.
 	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
 	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Takes a printf() style format so that a call (like those in NoteOn() or Render()) doesn't have to
+	build a std::string, which would allocate even if logging is disabled.
 */
 
 #pragma once
 
-#include <string>
-
 #include "../synth-global.h"
 
 namespace SFM
 {
-	void Log(const std::string &message);
+	void Log(const char *format, ...);
 }
@@ -9,31 +9,69 @@
 #include "../3rdparty/tinymt/tinymt32.c"
 #include "../3rdparty/tinymt/tinymt64.c"
 
+#include <atomic>
+
 #include "synth-random.h"
 
 namespace SFM
 {
-	static tinymt32_t s_genState32;
-	static tinymt64_t s_genState64;
+	// Each thread (voice render workers, parts on a pool, the render thread itself) has it's own state, which is seeded
+	// on first use; no two threads can touch the same state, and there's no need for any synchronization
+	static thread_local bool s_isSeeded = false;
+	static thread_local tinymt32_t s_genState32;
+	static thread_local tinymt64_t s_genState64;
+
+	// Base seeds & number of threads seeded so far
+	static std::atomic<uint32_t> s_seed32(0), s_seed64(0);
+	static std::atomic<uint32_t> s_numSeeded(0);
+
+	static void SeedThread(uint32_t index)
+	{
+		// Every thread gets a different seed (golden ratio increment, see Knuth)
+		const uint32_t offset = index*0x9e3779b9u;
+
+		tinymt32_init(&s_genState32, s_seed32+offset);
+		tinymt64_init(&s_genState64, s_seed64+offset);
+
+		s_isSeeded = true;
+	}
+
+	static void SeedThread()
+	{
+		// Index 0 is reserved for the thread that calls InitializeRandomGenerator()
+		SeedThread(s_numSeeded.fetch_add(1) + 1);
+	}
 
 	void InitializeRandomGenerator()
 	{
-		tinymt32_init(&s_genState32, rand());
-		tinymt64_init(&s_genState64, rand());
+		s_seed32 = uint32_t(rand());
+		s_seed64 = uint32_t(rand());
+
+		// (Re)seed calling thread, it may have drawn before (e.g. whilst constructing Bison's members)
+		SeedThread(0);
 	}
 
 	double mt_rand()
 	{
+		if (false == s_isSeeded)
+			SeedThread();
+
 		return tinymt64_generate_doubleOO(&s_genState64);
 	}
 
 	float mt_randf()
 	{
+		if (false == s_isSeeded)
+			SeedThread();
+
 		return tinymt32_generate_floatOO(&s_genState32);
 	}
 
 	uint32_t mt_randu32()
 	{
+		if (false == s_isSeeded)
+			SeedThread();
+
 		return tinymt32_generate_uint32(&s_genState32);
 	}
 
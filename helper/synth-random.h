@@ -19,6 +19,8 @@ namespace SFM
 		mt_randu32() -- Unsigned 32-bit
 		mt_rand32()  -- Signed 32-bit
 		mt_randfc()  -- Returns FP random value between -1.f and 1.f
+
+		All of these are thread-safe: each thread draws from it's own generator (see synth-random.cpp)
 	*/
 
 	double mt_rand();
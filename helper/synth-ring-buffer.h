@@ -1,14 +1,16 @@
 
 /*
-	FM. BISON hybrid FM synthesis -- Audio streaming (lockless) ring buffer.
+	FM. BISON hybrid FM synthesis -- Audio streaming (lockless) ring buffer & wait-free SPSC queue.
 	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
 	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
 
-	FIXME: templatize
+	FIXME: templatize RingBuffer
 */
 
 #pragma once
 
+#include <atomic>
+
 #include "../synth-global.h"
 
 namespace SFM
@@ -81,6 +83,66 @@ namespace SFM
 		unsigned m_readIdx;
 		unsigned m_writeIdx;
 	};
-}
 
-	
\ No newline at end of file
+	/*
+		Wait-free single producer, single consumer queue (used to hand events to the audio thread, see FM_BISON.h)
+
+		- Storage is part of the object, so it never allocates; capacity must be a power of 2
+		- Elements are copied in and out, so stick to trivial types
+		- Exactly one thread may call Push() and exactly one (other) thread may call Pop()
+	*/
+
+	template<typename T, unsigned kCapacity> class SPSCRingBuffer
+	{
+		static_assert(0 == (kCapacity & (kCapacity-1)), "SPSCRingBuffer capacity must be a power of 2");
+
+	public:
+		SPSCRingBuffer() :
+			m_readIdx(0)
+,			m_writeIdx(0)
+		{
+		}
+
+		// Returns false if full (element is dropped)
+		SFM_INLINE bool Push(const T &element)
+		{
+			const unsigned writeIdx = m_writeIdx.load(std::memory_order_relaxed);
+			
+			// Overrun?
+			if (writeIdx-m_readIdx.load(std::memory_order_acquire) == kCapacity)
+				return false;
+
+			m_elements[writeIdx & (kCapacity-1)] = element;
+			m_writeIdx.store(writeIdx+1, std::memory_order_release);
+
+			return true;
+		}
+
+		// Returns false if empty
+		SFM_INLINE bool Pop(T &element)
+		{
+			const unsigned readIdx = m_readIdx.load(std::memory_order_relaxed);
+
+			if (readIdx == m_writeIdx.load(std::memory_order_acquire))
+				return false;
+
+			element = m_elements[readIdx & (kCapacity-1)];
+			m_readIdx.store(readIdx+1, std::memory_order_release);
+
+			return true;
+		}
+
+		// Only a snapshot, of course
+		SFM_INLINE bool IsEmpty() const
+		{
+			return m_readIdx.load(std::memory_order_acquire) == m_writeIdx.load(std::memory_order_acquire);
+		}
+
+	private:
+		T m_elements[kCapacity];
+
+		// Each written by one side only; on their own cache line so they don't share it
+		alignas(64) std::atomic<unsigned> m_readIdx;
+		alignas(64) std::atomic<unsigned> m_writeIdx;
+	};
+}
@@ -0,0 +1,76 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Wait-free triple buffer (latest value wins).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Hands a (large) object from one thread to another without locks: the writer fills its own buffer and
+	publishes it by swapping it with the shared (middle) one, the reader swaps that with its own buffer only
+	if something new was published; neither side ever waits and neither copies on publish or pick-up.
+
+	- Unlike SPSCRingBuffer intermediate values are skipped: the reader always gets the latest one
+	- The write buffer's contents after Publish() are stale, so write it in full each time
+	- Exactly one thread may write & publish and exactly one (other) thread may update & read
+*/
+
+#pragma once
+
+#include <atomic>
+
+#include "../synth-global.h"
+
+namespace SFM
+{
+	template<typename T> class TripleBuffer
+	{
+		// Index (low bits) of middle buffer plus a bit that's set if it wasn't picked up yet
+		static constexpr unsigned kIndexMask = 3;
+		static constexpr unsigned kFreshBit  = 4;
+
+	public:
+		TripleBuffer() :
+			m_middle(1)
+,			m_writeIdx(0)
+,			m_readIdx(2)
+		{
+		}
+
+		// Writer
+		SFM_INLINE T &GetWriteBuffer()
+		{
+			return m_buffers[m_writeIdx];
+		}
+
+		SFM_INLINE void Publish()
+		{
+			const unsigned middle = m_middle.exchange(m_writeIdx | kFreshBit, std::memory_order_acq_rel);
+			m_writeIdx = middle & kIndexMask;
+		}
+
+		// Reader: returns true if a newly published buffer is now current
+		SFM_INLINE bool Update()
+		{
+			if (0 == (m_middle.load(std::memory_order_relaxed) & kFreshBit))
+				return false;
+
+			const unsigned middle = m_middle.exchange(m_readIdx, std::memory_order_acq_rel);
+			m_readIdx = middle & kIndexMask;
+
+			return true;
+		}
+
+		SFM_INLINE const T &Read() const
+		{
+			return m_buffers[m_readIdx];
+		}
+
+	private:
+		T m_buffers[3];
+
+		alignas(64) std::atomic<unsigned> m_middle;
+
+		// Each owned by one side only
+		alignas(64) unsigned m_writeIdx;
+		alignas(64) unsigned m_readIdx;
+	};
+}
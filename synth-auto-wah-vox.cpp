@@ -19,8 +19,51 @@ namespace SFM
 	constexpr float kVoxRateScale  =   2.f; // Rate ratio: vox. S&H
 	constexpr float kCutRateScale  = 0.25f; // Rate ratio: cutoff modulation
 	
+	void AutoWah::Reset()
+	{
+		m_peak.Reset();
+		m_gainEnvdB.Reset(kInfdB);
+
+		m_preFilterHPF.resetState();
+		m_postFilterLPF.resetState();
+
+		m_voxGhostEnv.Reset();
+		m_vowelizerV1.Reset();
+		m_voxLPF.resetState();
+
+		m_LFO.Reset();
+
+		m_tail.Reset();
+	}
+
 	void AutoWah::Apply(float *pLeft, float *pRight, unsigned numSamples, bool manualRate)
 	{
+		// Bypass (output equals input) if muted or if the input is silent and so is the tail
+		const bool isMuted = true == m_curWet.IsDone() && 0.f == m_curWet.Get();
+		if (true == isMuted || (true == m_tail.IsSilent() && GetRectifiedMaximum(pLeft, pRight, numSamples) <= kInfLin))
+		{
+			// Start from scratch when wet goes up again
+			if (false == m_tail.IsSilent())
+				Reset();
+
+			// Keep parameters in pace
+			m_curResonance.Skip(numSamples);
+			m_curAttack.Skip(numSamples);
+			m_curHold.Skip(numSamples);
+			m_curRate.Skip(numSamples);
+			m_curDrivedB.Skip(numSamples);
+			m_curSpeak.Skip(numSamples);
+			m_curSpeakVowel.Skip(numSamples);
+			m_curSpeakVowelMod.Skip(numSamples);
+			m_curSpeakGhost.Skip(numSamples);
+			m_curSpeakCut.Skip(numSamples);
+			m_curSpeakReso.Skip(numSamples);
+			m_curCut.Skip(numSamples);
+			m_curWet.Skip(numSamples);
+
+			return;
+		}
+
 		// FIXME: VowelizerV1 only supports a fixed sample rate, so we'll just skip the nearest amount of samples
 		//        so it will sound nearly the same at different sample rates; must be replaced by my own vocoder soon!
 
@@ -30,6 +73,8 @@ namespace SFM
 
 		float vowelHoldL = 0.f, vowelHoldR = 0.f;
 
+		float inputPeak = 0.f, tailPeak = 0.f;
+
 		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
 		{
 			// Sample parameters
@@ -172,6 +217,9 @@ namespace SFM
 				m_voxLPF.resetState();
 			}
 
+			inputPeak = std::max<float>(inputPeak, GetRectifiedMaximum(sampleL, sampleR));
+			tailPeak  = std::max<float>(tailPeak,  GetRectifiedMaximum(filteredL, filteredR));
+
 			/*
 				Final mix
 			*/
@@ -179,5 +227,7 @@ namespace SFM
 			pLeft[iSample]  = lerpf<float>(sampleL, filteredL, wetness);
 			pRight[iSample] = lerpf<float>(sampleR, filteredR, wetness);
 		}
+
+		m_tail.Run(inputPeak, tailPeak, numSamples);
 	}
 }
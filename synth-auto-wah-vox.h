@@ -50,6 +50,7 @@ namespace SFM
 ,			m_curSpeakReso(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,			m_curCut(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,			m_curWet(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
+,			m_tail(unsigned(sampleRate*kMaxWahGhostReleaseMS*0.001f))
 		{
 			m_voxOscPhase.Initialize(kDefWahRate, sampleRate);
 			m_voxSandH.SetSlewRate(kWahVoxSandHSlewRate);
@@ -91,9 +92,17 @@ namespace SFM
 			m_curWet.SetTarget(wetness);
 		}
 
+		// Bypassed whilst wet is zero (state is reset) or input and tail are silent
 		void Apply(float *pLeft, float *pRight, unsigned numSamples, bool manualRate);
 
+		bool IsSilent() const
+		{
+			return m_tail.IsSilent();
+		}
+
 	private:
+		void Reset();
+
 		const unsigned m_sampleRate;
 		const unsigned m_Nyquist;
 
@@ -126,5 +135,8 @@ namespace SFM
 		InterpolatedParameter<kLinInterpolate, true> m_curSpeakReso;
 		InterpolatedParameter<kLinInterpolate, true> m_curCut;
 		InterpolatedParameter<kLinInterpolate, true> m_curWet;
+
+		// Input & tail silence (filters, vowelizer & 'ghost' envelope)
+		SilenceDetect m_tail;
 	};
 }
@@ -14,7 +14,73 @@ namespace SFM
 	float Compressor::Apply(float *pLeft, float *pRight, unsigned numSamples, bool autoGain, float RMSToPeak)
 	{
 		SFM_ASSERT_NORM(RMSToPeak);
-		
+
+		// Neutral: 1:1 ratio, no gain (reduction) and a fixed lookahead
+		const bool isNeutral = false == autoGain &&
+		                       true == m_curRatio.IsDone()     && kMinCompRatio == m_curRatio.Get() &&
+		                       true == m_curGaindB.IsDone()    && 0.f == m_curGaindB.Get() &&
+		                       true == m_curLookahead.IsDone() && fabsf(m_gainEnvdB.Get()) < kCompBypassdB;
+
+		float bite = 0.f;
+
+		if (true == isNeutral)
+		{
+			// Delay signal only, but keep detecting so the compressor responds right away when it leaves 1:1 (and bite registers)
+			const float invLookahead = 1.f-m_curLookahead.Get();
+
+			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			{
+				const float thresholddB = m_curThresholddB.Sample();
+				const float kneedB      = m_curKneedB.Sample();
+
+				const float sampleL = pLeft[iSample];
+				const float sampleR = pRight[iSample];
+
+				m_outDelayL.Write(sampleL);
+				m_outDelayR.Write(sampleR);
+
+				const float RMSdB = m_RMS.Run(sampleL, sampleR);
+				const float peakdB = m_peak.Run(sampleL, sampleR);
+				const float signaldB = lerpf<float>(RMSdB, peakdB, RMSToPeak);
+
+				// See below (soft knee lowers threshold)
+				if (signaldB > thresholddB - kneedB*0.5f)
+					bite += 1.f;
+
+				pLeft[iSample]  = m_outDelayL.ReadNormalized(invLookahead);
+				pRight[iSample] = m_outDelayR.ReadNormalized(invLookahead);
+			}
+
+			m_curAttack.Skip(numSamples);
+			m_curRelease.Skip(numSamples);
+
+			m_isBypassed = true;
+		}
+		else
+		{
+			if (true == m_isBypassed)
+			{
+				// Gain envelope has been idle (at unit gain)
+				m_gainEnvdB.Reset(0.f);
+
+				m_isBypassed = false;
+			}
+
+			bite = ApplyCompression(pLeft, pRight, numSamples, autoGain, RMSToPeak);
+		}
+
+		if (numSamples > 0)
+		{
+			bite = bite/numSamples;
+			SFM_ASSERT_NORM(bite);
+		}
+
+		return bite;
+	}
+
+	// Returns number of samples that "bite"
+	float Compressor::ApplyCompression(float *pLeft, float *pRight, unsigned numSamples, bool autoGain, float RMSToPeak)
+	{
 		float bite = 0.f;
 
 		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
@@ -105,12 +171,6 @@ namespace SFM
 			pRight[iSample] = delayedR*gain;
 		}
 
-		if (numSamples > 0)
-		{
-			bite = bite/numSamples;
-			SFM_ASSERT_NORM(bite);
-		}
-
 		return bite;
 	}
 }
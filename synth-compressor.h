@@ -23,6 +23,7 @@ namespace SFM
 	constexpr float kCompRMSWindowSec      = 0.400f; // 400MS (EBU R 128 'Momentary', https://tech.ebu.ch/docs/tech/tech3341.pdf)
 	constexpr float kCompLookaheadMS       =   10.f; //  10MS (5MS-10MS seems to be an acceptable range in the audio world)
 	constexpr float kCompAutoGainSlewInSec = 0.100f; // 100MS
+	constexpr float kCompBypassdB          = 0.0001f; // Gain (reduction) below which the compressor is transparent
 
 	class Compressor
 	{
@@ -68,6 +69,8 @@ namespace SFM
 		}
 		
 		// Returns "bite" (can be used for a visual indicator)
+		// Bypassed (lookahead delay only, so latency is unaffected) whilst ratio is 1:1 and there's no (make-up) gain;
+		// detection (RMS & peak) keeps running, so bite still registers and there's no warming up once it's engaged
 		float Apply(float *pLeft, float *pRight, unsigned numSamples, bool autoGain, float RMSToPeak /* FIXME: interpolate as well? */);
 
 		SFM_INLINE float GetLatency() const
@@ -77,6 +80,8 @@ namespace SFM
 		}
 
 	private:
+		float ApplyCompression(float *pLeft, float *pRight, unsigned numSamples, bool autoGain, float RMSToPeak);
+
 		const unsigned m_sampleRate;
 
 		DelayLine m_outDelayL, m_outDelayR;
@@ -88,6 +93,8 @@ namespace SFM
 		const float m_autoGainCoeff;
 		float m_autoGainDiff = 0.f;
 
+		bool m_isBypassed = false;
+
 		// Interpolated parameters
 		InterpolatedParameter<kLinInterpolate, false> m_curThresholddB;
 		InterpolatedParameter<kLinInterpolate, false> m_curKneedB;
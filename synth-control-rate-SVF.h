@@ -0,0 +1,121 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- SvfLinearTrapOptimised2 with control rate coefficients.
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Cutoff & Q are interpolated per sample, but calculating the coefficients from them (tan() plus a few divisions)
+	every sample for every voice adds up; this filter only calculates 'g' & 'k' every 'controlRate' samples, and
+	only if cutoff, Q or type changed, and linearly interpolates them in between
+
+	- Coefficients lag behind by (at most) 'controlRate' samples
+	- 'g' is approximated by fast_tanpif() (see synth-fast-tan.h)
+	- After Reset() (or a type change) the first update is taken as is
+*/
+
+#pragma once
+
+#include "3rdparty/filters/SvfLinearTrapOptimised2.hpp"
+
+#include "synth-global.h"
+
+namespace SFM
+{
+	class ControlRateSVF
+	{
+	public:
+		ControlRateSVF()
+		{
+			Reset();
+		}
+
+		void Reset()
+		{
+			m_filter.resetState();
+
+			m_type = SvfLinearTrapOptimised2::NO_FLT_TYPE;
+			m_countdown = 0;
+			m_numSteps = 0;
+		}
+
+		// Call once per sample, before Tick(); 'controlRate' is in samples
+		SFM_INLINE void Update(float cutoffHz, float Q, SvfLinearTrapOptimised2::FLT_TYPE type, unsigned sampleRate, unsigned controlRate)
+		{
+			SFM_ASSERT(SvfLinearTrapOptimised2::NO_FLT_TYPE != type);
+			SFM_ASSERT(controlRate > 0);
+
+			if (0 == m_countdown)
+			{
+				m_countdown = controlRate;
+
+				if (cutoffHz != m_cutoffHz || Q != m_Q || type != m_type)
+				{
+					m_cutoffHz = cutoffHz;
+					m_Q = Q;
+
+					// Keep away from Nyquist, tan() goes to infinity there
+					constexpr float kMaxRatio = 0.4999f;
+					const float ratio = std::min<float>(kMaxRatio, cutoffHz/sampleRate);
+
+					m_targetG = fast_tanpif(ratio);
+					m_targetK = 1.f/Q;
+
+					if (type != m_type)
+					{
+						// Take as is
+						m_type = type;
+						m_g = m_targetG;
+						m_k = m_targetK;
+						m_numSteps = 0;
+
+						m_filter.updateCoefficientsGK(m_g, m_k, m_type);
+					}
+					else
+					{
+						// Interpolate over next 'controlRate' samples
+						m_deltaG = (m_targetG-m_g)/controlRate;
+						m_deltaK = (m_targetK-m_k)/controlRate;
+						m_numSteps = controlRate;
+					}
+				}
+			}
+
+			--m_countdown;
+
+			if (m_numSteps > 0)
+			{
+				if (0 == --m_numSteps)
+				{
+					m_g = m_targetG;
+					m_k = m_targetK;
+				}
+				else
+				{
+					m_g += m_deltaG;
+					m_k += m_deltaK;
+				}
+
+				m_filter.updateCoefficientsGK(m_g, m_k, m_type);
+			}
+		}
+
+		SFM_INLINE void Tick(float &left, float &right)
+		{
+			SFM_ASSERT(SvfLinearTrapOptimised2::NO_FLT_TYPE != m_type);
+			m_filter.tick(left, right);
+		}
+
+	private:
+		SvfLinearTrapOptimised2 m_filter;
+
+		SvfLinearTrapOptimised2::FLT_TYPE m_type;
+		float m_cutoffHz = 0.f, m_Q = 0.f;
+
+		unsigned m_countdown; // Samples left until next control update
+		unsigned m_numSteps;  // Samples left to interpolate
+
+		float m_g = 0.f, m_k = 0.f;
+		float m_targetG = 0.f, m_targetK = 0.f;
+		float m_deltaG = 0.f, m_deltaK = 0.f;
+	};
+}
@@ -55,8 +55,17 @@
 // Define to disable all FX (including per-voice filter)
 // #define SFM_DISABLE_FX
 
-// Define to disable extra voice rendering thread
-#define SFM_DISABLE_VOICE_THREAD
+// Define to disable voice rendering worker threads (see synth-thread-pool.h)
+// #define SFM_DISABLE_VOICE_THREAD
+
+// Define to disable the vectorized (SSE2) operator kernel (see synth-operator-kernel.h)
+// #define SFM_DISABLE_SIMD_OPERATORS
+
+// Define to render voices sample by sample (reference for the staged block render, see Voice::Render())
+// #define SFM_DISABLE_BLOCK_VOICE_RENDER
+
+// Define to abort on any allocation made inside Render(), a test mode (see helper/synth-allocation-guard.h)
+// #define SFM_DETECT_RENDER_ALLOCATIONS
 
 namespace SFM
 {
@@ -75,11 +84,11 @@ namespace SFM
 	// Voices
 	// ----------------------------------------------------------------------------------------------
 
-	// Max. number of voices & samples to render using the main (single) thread
-	// 32 is based on 64 being a reasonable total
+	// Max. number of voices & min. number of samples to render using the main (single) thread
+	// Workers are persistent (see synth-thread-pool.h) so handing off a block is cheap, but not free
 	// Only relevant when !defined(SFM_DISABLE_VOICE_THREAD)
-	constexpr unsigned kSingleThreadMaxVoices = 32;
-	constexpr unsigned kMultiThreadMinSamples = 512;
+	constexpr unsigned kSingleThreadMaxVoices = 16;
+	constexpr unsigned kMultiThreadMinSamples = 64;
 
 	// Max. fixed frequency (have fun with it!)
 	constexpr float kMaxFixedHz = 96000.f;
@@ -92,6 +101,12 @@ namespace SFM
 	// Default number of vioces
 	constexpr unsigned kDefMaxPolyVoices = 32; // Safe and fast
 
+	// Default grid (in samples) blocks are split on to handle events (see Bison::SetEventGrid())
+	constexpr unsigned kDefEventGrid = 16;
+
+	// Default rate (in samples) at which the main filter's coefficients are calculated (see Bison::SetFilterControlRate())
+	constexpr unsigned kDefFilterControlRate = 16;
+
 	// ----------------------------------------------------------------------------------------------
 	// Default InterpolatedParameter latency (used for per-sample interpolation)
 	// ----------------------------------------------------------------------------------------------
@@ -253,6 +268,10 @@ namespace SFM
 	constexpr float kInfdB  = -100.f; 
 	constexpr float kInfLin = 9.99999975e-06f; // dB2Lin(kInfdB)
 
+	// Default sleep floor & number of (silent) blocks before falling asleep (see Bison::SetSleep())
+	constexpr float kDefSleepFloordB = kInfdB;
+	constexpr unsigned kDefSleepNumBlocks = 8;
+
 	// ----------------------------------------------------------------------------------------------
 	// (Monophonic) frequency glide (in seconds)
 	// ----------------------------------------------------------------------------------------------
@@ -395,6 +414,9 @@ namespace SFM
 #include "helper/synth-helper.h"
 #include "helper/synth-fast-tan.h"
 #include "helper/synth-fast-cosine.h"
+#include "helper/synth-allocation-guard.h"
 #include "helper/synth-aligned-alloc.h"
 #include "helper/synth-ring-buffer.h"
+#include "helper/synth-fixed-vector.h"
+#include "helper/synth-triple-buffer.h"
 #include "helper/synth-MIDI.h"
@@ -4,14 +4,15 @@
 	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
 	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
 
-	This object is used to interpolate parameters that need per-sample interpolation in the time domain so that it 
+	This object is used to interpolate parameters that need per-sample interpolation in the time domain so that it
 	will always reproduce the same effect regardless of the number of samples processed per block or the sample rate.
 	Alternatively a fixed number of samples can be set.
 
 	When using kMulInterpolate the target value may never be zero!
 
 	Do *always* call Set() and SetTarget() after calling SetRate() during interpolation to restore the current value
-	and set the new target. This is a small design flaw in juce::SmoothedValue if you ask me.
+	and set the new target, SetRate() snaps to the target (like juce::SmoothedValue::reset() did, and a lot of code
+	depends on that).
 
 	Like so:
 		const float curValue = interpolator.Get();
@@ -19,39 +20,74 @@
 		interpolator.Set(curValue);
 		interpolator.SetTarget(targetValue);
 
-	I'm not fixing this as long as we use juce::SmoothedValue.
-
 	IMPORTANT: use the clamp feature for values that should *not* go out of range; if a small under- or overshoot is
 	           no problem, please set it to false and save yourself a few branches
- 
- 	06/04/2022: Adapt Alara version?
-	
-	FIXME: 
-	- Replace JUCE implementation (also in other places where juce::SmoothedValue is used)
-	- Model own implementation after this one
+
+	16/10/2026: replaced juce::SmoothedValue (same stepping, so same results within range) by this implementation:
+	- Once settled Sample() returns a constant (already clamped) value, no arithmetic
+	- Block functions: SampleBlock() fills a buffer with the ramp or tells you it's constant, RenderBlock() always fills
+	- Multiplicative interpolation uses a precomputed ratio per step
+	- Minimum & maximum are only stored if clamping, making an unclamped parameter 20 bytes (JUCE's object alone was 20)
 */
 
 #pragma once
 
-// Include JUCE (for juce::SmoothedValue)
-#include <JuceHeader.h>
+#include <type_traits>
 
 #include "synth-global.h"
 
 namespace SFM
 {
-	typedef juce::ValueSmoothingTypes::Linear kLinInterpolate;
-	typedef juce::ValueSmoothingTypes::Multiplicative kMulInterpolate; // Target value may *never* be zero!
+	// Interpolation types
+	struct kLinInterpolate {};
+	struct kMulInterpolate {}; // Target value may *never* be zero!
+
+	// Range, only stored (and applied) if clamping
+	template <bool clamp>
+	class InterpolatedParameterRange
+	{
+	protected:
+		InterpolatedParameterRange(float minimum, float maximum) :
+			m_minimum(minimum), m_maximum(maximum)
+		{
+			SFM_ASSERT(minimum <= maximum);
+		}
+
+		SFM_INLINE float Clamp(float value) const
+		{
+			return std::max<float>(m_minimum, std::min<float>(m_maximum, value));
+		}
+
+	private:
+		float m_minimum;
+		float m_maximum;
+	};
+
+	template <>
+	class InterpolatedParameterRange<false>
+	{
+	protected:
+		InterpolatedParameterRange(float /* minimum */, float /* maximum */) {}
+
+		SFM_INLINE float Clamp(float value) const
+		{
+			return value;
+		}
+	};
 
 	template <typename T, bool clamp>
-	class InterpolatedParameter
+	class InterpolatedParameter : private InterpolatedParameterRange<clamp>
 	{
+		static_assert(std::is_same<T, kLinInterpolate>::value || std::is_same<T, kMulInterpolate>::value, "Unknown interpolation type");
+
+		using InterpolatedParameterRange<clamp>::Clamp;
+
 	public:
 		// Default: zero
 		// If you comment this constructor it's easier to spot forgotten initializations
 		// FIXME: as of 04/2022, fixing the minimum and maximum for compiler compliance, I've seen the above happening more than a few times!
 		InterpolatedParameter() :
-			m_minimum(0.f), m_maximum(1.f)
+			InterpolatedParameterRange<clamp>(0.f, 1.f)
 		{
 			SetRate(0);
 			Set(0.f);
@@ -59,8 +95,7 @@ namespace SFM
 
 		// Initialize at value and initialize rate & time
 		InterpolatedParameter(float value, unsigned sampleRate, float timeInSec, float minimum, float maximum) :
-			m_minimum(minimum), m_maximum(maximum),
-			m_value(value)
+			InterpolatedParameterRange<clamp>(minimum, maximum)
 		{
 			SFM_ASSERT(timeInSec >= 0.f);
 			SetRate(sampleRate, timeInSec);
@@ -69,73 +104,174 @@ namespace SFM
 
 		// Initialize at value and initialize rate & time
 		InterpolatedParameter(float value, unsigned numSamples, float minimum, float maximum) :
-			m_minimum(minimum), m_maximum(maximum),
-			m_value(value)
+			InterpolatedParameterRange<clamp>(minimum, maximum)
 		{
 			SFM_ASSERT(numSamples > 0);
 			SetRate(numSamples);
 			Set(value);
 		}
-		
+
 		SFM_INLINE float Sample()
 		{
-			const float result = m_value.getNextValue();
-			return (clamp) ? jlimit<float>(m_minimum, m_maximum, result) : result;
+			// Settled (most of the time): constant
+			if (0 == m_countdown)
+				return m_current;
+
+			return Step();
 		}
 
 		SFM_INLINE float Get() const
 		{
-			const float result = m_value.getCurrentValue();
-			return (clamp) ? jlimit<float>(m_minimum, m_maximum, result) : result;		}
+			return Clamp(m_current);
+		}
+
+		// Sample 'numSamples' values: returns true if constant (see Get()), in which case 'pDest' is left untouched
+		SFM_INLINE bool SampleBlock(float *pDest, unsigned numSamples)
+		{
+			SFM_ASSERT(nullptr != pDest);
+
+			if (0 == m_countdown)
+				return true;
+
+			RenderRamp(pDest, numSamples);
+
+			return false;
+		}
+
+		// Sample 'numSamples' values to 'pDest'
+		SFM_INLINE void RenderBlock(float *pDest, unsigned numSamples)
+		{
+			SFM_ASSERT(nullptr != pDest);
+
+			if (0 == m_countdown)
+			{
+				const float value = m_current;
+				for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+					pDest[iSample] = value;
+			}
+			else
+				RenderRamp(pDest, numSamples);
+		}
 
 		// Set current & target
 		SFM_INLINE void Set(float value)
 		{
-			m_value.setCurrentAndTargetValue(value);
+			m_target = value;
+			Settle();
 		}
 
 		// Set target
 		SFM_INLINE void SetTarget(float value)
 		{
-			m_value.setTargetValue(value);
+			if (value == m_target)
+				return;
+
+			if (0 == m_numSteps)
+			{
+				Set(value);
+				return;
+			}
+
+			m_target = value;
+			m_countdown = m_numSteps;
+
+			if (true == std::is_same<T, kLinInterpolate>::value)
+			{
+				m_step = (m_target-m_current)/float(m_countdown);
+			}
+			else
+			{
+				SFM_ASSERT(0.f != m_target && 0.f != m_current);
+				m_step = expf((logf(fabsf(m_target)) - logf(fabsf(m_current)))/float(m_countdown));
+			}
 		}
-		
+
 		// Get target
 		SFM_INLINE float GetTarget() const
 		{
-			return (float) m_value.getTargetValue();
+			return m_target;
 		}
 
 		// Skip over N samples towards target value
 		SFM_INLINE void Skip(unsigned numSamples)
 		{
-			m_value.skip(numSamples);
+			if (numSamples >= m_countdown)
+			{
+				Settle();
+				return;
+			}
+
+			if (true == std::is_same<T, kLinInterpolate>::value)
+				m_current += m_step*numSamples;
+			else
+				m_current *= powf(m_step, float(numSamples));
+
+			m_countdown -= numSamples;
 		}
 
 		// Set rate in seconds
 		SFM_INLINE void SetRate(unsigned sampleRate, float time)
 		{
-			m_value.reset(double(sampleRate), double(time));
+			SFM_ASSERT(time >= 0.f);
+			SetRate(unsigned(floor(double(time)*sampleRate)));
 		}
-		
+
 		// Set rate in samples
 		SFM_INLINE void SetRate(unsigned numSamples)
 		{
-			m_value.reset(numSamples);
+			m_numSteps = numSamples;
+			Settle();
 		}
 
 		// Is no longer interpolating
-		SFM_INLINE bool IsDone()
+		SFM_INLINE bool IsDone() const
 		{
-			return false == m_value.isSmoothing();
+			return 0 == m_countdown;
 		}
 
 	private:
-		// As of 2022 I still can't use floating point template arguments; this sucks because now we'll have to keep 2 constants
-		// The 'need to clamp' branch however should be eliminated at compile time, so it's not that bad
-		float m_minimum;
-		float m_maximum;
-		
-		juce::SmoothedValue<float, T> m_value;
+		SFM_INLINE void Settle()
+		{
+			m_current = Clamp(m_target);
+			m_countdown = 0;
+		}
+
+		SFM_INLINE float Step()
+		{
+			SFM_ASSERT(m_countdown > 0);
+
+			if (0 == --m_countdown)
+			{
+				Settle();
+				return m_current;
+			}
+
+			if (true == std::is_same<T, kLinInterpolate>::value)
+				m_current += m_step;
+			else
+				m_current *= m_step;
+
+			return Clamp(m_current);
+		}
+
+		SFM_INLINE void RenderRamp(float *pDest, unsigned numSamples)
+		{
+			const unsigned numSteps = std::min<unsigned>(numSamples, m_countdown);
+
+			unsigned iSample = 0;
+			for (; iSample < numSteps; ++iSample)
+				pDest[iSample] = Step();
+
+			// Settled halfway through
+			const float value = m_current;
+			for (; iSample < numSamples; ++iSample)
+				pDest[iSample] = value;
+		}
+
+		float m_current = 0.f;
+		float m_target = 0.f;
+		float m_step = 0.f;    // Linear: added, multiplicative: ratio
+		unsigned m_countdown;  // Steps left to target (0 = settled)
+		unsigned m_numSteps;   // Steps to target (see SetRate())
 	};
 };
@@ -69,6 +69,7 @@ namespace SFM
 		void Reset()
 		{
 			m_line.Reset();
+			m_sum = 0.f;
 		}
 
 	private:
@@ -116,4 +117,40 @@ namespace SFM
 		SignalFollower m_peakEnv;
 		float m_peak = 0.f;
 	};
+
+	// Tells if a processor with memory (delay line, comb filters, envelopes) has gone quiet: both it's input and it's
+	// output (tail) must have stayed below kInfLin for as long as it can remember, after which it can be bypassed
+	// until the input isn't silent anymore
+	class SilenceDetect
+	{
+	public:
+		SilenceDetect(unsigned memoryInSamples) :
+			m_memory(memoryInSamples)
+,			m_numSilent(memoryInSamples) // No state, no tail
+		{}
+
+		// Call once per processed block with the peak of input & output
+		SFM_INLINE void Run(float inputPeak, float outputPeak, unsigned numSamples)
+		{
+			if (inputPeak > kInfLin || outputPeak > kInfLin)
+				m_numSilent = 0;
+			else
+				m_numSilent = std::min<unsigned>(m_memory, m_numSilent+numSamples);
+		}
+
+		SFM_INLINE bool IsSilent() const
+		{
+			return m_numSilent >= m_memory;
+		}
+
+		// Call when the processor's state is cleared
+		SFM_INLINE void Reset()
+		{
+			m_numSilent = m_memory;
+		}
+
+	private:
+		const unsigned m_memory;
+		unsigned m_numSilent;
+	};
 }
@@ -24,4 +24,124 @@ namespace SFM
 		m_trebledB.SetTarget(trebledB);
 		m_middB.SetTarget(middB);
 	}
+
+	void MiniEQ::Process(float *pLeft, float *pRight, unsigned numSamples)
+	{
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
+
+		unsigned iSample = 0;
+
+		// Per sample whilst interpolating
+		for (; iSample < numSamples && false == IsSettled(); ++iSample)
+			Apply(pLeft[iSample], pRight[iSample]);
+
+		if (iSample == numSamples)
+			return;
+
+		unsigned numFiltered = numSamples-iSample;
+
+		if (true == IsFlat())
+		{
+			numFiltered = std::min<unsigned>(numFiltered, m_flatCountdown);
+			m_flatCountdown -= numFiltered;
+		}
+
+		FilterSettled(pLeft+iSample, pRight+iSample, numFiltered);
+
+		// Bypassed
+		for (iSample += numFiltered; iSample < numSamples; ++iSample)
+		{
+			pLeft[iSample]  *= kMiniEQFlatGain;
+			pRight[iSample] *= kMiniEQFlatGain;
+		}
+	}
+
+#if defined(SFM_SIMD_MINI_EQ)
+
+	// Biquad in lanes, same math as Biquad::process()
+	SFM_INLINE static __m128 ProcessBiquadLanes(__m128 sample, __m128 a0, __m128 a1, __m128 a2, __m128 b1, __m128 b2, __m128 &z1, __m128 &z2)
+	{
+		const __m128 out = _mm_add_ps(_mm_mul_ps(sample, a0), z1);
+		z1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(sample, a1), z2), _mm_mul_ps(b1, out));
+		z2 = _mm_sub_ps(_mm_mul_ps(sample, a2), _mm_mul_ps(b2, out));
+
+		return out;
+	}
+
+	void MiniEQ::FilterSettled(float *pLeft, float *pRight, unsigned numSamples)
+	{
+		if (0 == numSamples)
+			return;
+
+		// Mid peak: [L, R, L, R] (upper half is a copy, so the result can be fed to the shelves as is)
+		float midA0, midA1, midA2, midB1, midB2;
+		float midZ1L, midZ2L, midZ1R, midZ2R;
+		m_midPeak.getCoefficients(midA0, midA1, midA2, midB1, midB2);
+		m_midPeak.getState(midZ1L, midZ2L, midZ1R, midZ2R);
+
+		const __m128 midA0s = _mm_set1_ps(midA0), midA1s = _mm_set1_ps(midA1), midA2s = _mm_set1_ps(midA2);
+		const __m128 midB1s = _mm_set1_ps(midB1), midB2s = _mm_set1_ps(midB2);
+		__m128 midZ1 = _mm_setr_ps(midZ1L, midZ1R, midZ1L, midZ1R);
+		__m128 midZ2 = _mm_setr_ps(midZ2L, midZ2R, midZ2L, midZ2R);
+
+		// Shelves: [bass L, bass R, treble L, treble R]
+		float loA0, loA1, loA2, loB1, loB2, hiA0, hiA1, hiA2, hiB1, hiB2;
+		float loZ1L, loZ2L, loZ1R, loZ2R, hiZ1L, hiZ2L, hiZ1R, hiZ2R;
+		m_bassShelf.getCoefficients(loA0, loA1, loA2, loB1, loB2);
+		m_trebleShelf.getCoefficients(hiA0, hiA1, hiA2, hiB1, hiB2);
+		m_bassShelf.getState(loZ1L, loZ2L, loZ1R, loZ2R);
+		m_trebleShelf.getState(hiZ1L, hiZ2L, hiZ1R, hiZ2R);
+
+		const __m128 a0 = _mm_setr_ps(loA0, loA0, hiA0, hiA0);
+		const __m128 a1 = _mm_setr_ps(loA1, loA1, hiA1, hiA1);
+		const __m128 a2 = _mm_setr_ps(loA2, loA2, hiA2, hiA2);
+		const __m128 b1 = _mm_setr_ps(loB1, loB1, hiB1, hiB1);
+		const __m128 b2 = _mm_setr_ps(loB2, loB2, hiB2, hiB2);
+		__m128 z1 = _mm_setr_ps(loZ1L, loZ1R, hiZ1L, hiZ1R);
+		__m128 z2 = _mm_setr_ps(loZ2L, loZ2R, hiZ2L, hiZ2R);
+
+		const __m128 gain = _mm_set1_ps(kNormalGainAtCutoff);
+
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			__m128 sample = _mm_setr_ps(pLeft[iSample], pRight[iSample], pLeft[iSample], pRight[iSample]);
+
+			if (true == m_withMid)
+				sample = ProcessBiquadLanes(sample, midA0s, midA1s, midA2s, midB1s, midB2s, midZ1, midZ2);
+
+			const __m128 shelves = ProcessBiquadLanes(sample, a0, a1, a2, b1, b2, z1, z2);
+
+			// (LO+HI)*kNormalGainAtCutoff
+			alignas(16) float mixed[4];
+			_mm_store_ps(mixed, _mm_mul_ps(_mm_add_ps(shelves, _mm_movehl_ps(shelves, shelves)), gain));
+
+			pLeft[iSample]  = mixed[0];
+			pRight[iSample] = mixed[1];
+		}
+
+		// Store state
+		alignas(16) float z1s[4], z2s[4];
+
+		if (true == m_withMid)
+		{
+			_mm_store_ps(z1s, midZ1);
+			_mm_store_ps(z2s, midZ2);
+			m_midPeak.setState(z1s[0], z2s[0], z1s[1], z2s[1]);
+		}
+
+		_mm_store_ps(z1s, z1);
+		_mm_store_ps(z2s, z2);
+		m_bassShelf.setState(z1s[0], z2s[0], z1s[1], z2s[1]);
+		m_trebleShelf.setState(z1s[2], z2s[2], z1s[3], z2s[3]);
+	}
+
+#else
+
+	void MiniEQ::FilterSettled(float *pLeft, float *pRight, unsigned numSamples)
+	{
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			Filter(pLeft[iSample], pRight[iSample]);
+	}
+
+#endif
 }
@@ -4,6 +4,13 @@
 	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
 	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
 
+	- Coefficients are only calculated whilst the gains are interpolating
+	- Once all gains are settled at 0dB (for kMiniEQFlatHoldInSec, to let the filters ring out) the filters are
+	  bypassed; the output is then simply the input times kMiniEQFlatGain
+	- Process() is vectorized (SSE2) once the gains are settled: bass & treble shelf in 4 lanes (L, R, L, R),
+	  preceded by the mid peak (in the same lanes); results are bit-identical to Apply(), so they can be A/B'd
+	  (define SFM_DISABLE_SIMD_MINI_EQ)
+
 	FIXME:
 		- Turn into (semi-)3-band full cut EQ
 */
@@ -13,6 +20,12 @@
 #include "3rdparty/filters/Biquad.h"
 
 #include "synth-global.h"
+
+#if !defined(SFM_DISABLE_SIMD_MINI_EQ) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define SFM_SIMD_MINI_EQ
+	#include <emmintrin.h>
+#endif
+
 #include "synth-interpolated-parameter.h"
 
 namespace SFM
@@ -25,6 +38,15 @@ namespace SFM
 	constexpr float kMidHz = 1200.f;
 	constexpr float kHiHz  = 4000.f;
 
+	// Gains are considered flat at this value (see SetTargetdBs())
+	constexpr float kMiniEQFlatdB = 0.f + kEpsilon;
+
+	// Gain of both shelves (at 0dB) summed (see Filter())
+	constexpr float kMiniEQFlatGain = 2.f*kNormalGainAtCutoff;
+
+	// Time the filters keep running after settling at 0dB
+	constexpr float kMiniEQFlatHoldInSec = 0.1f; // 100MS
+
 	class MiniEQ
 	{
 	public:
@@ -36,6 +58,8 @@ namespace SFM
 ,			m_bassdB(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,			m_trebledB(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,			m_middB(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
+,			m_flatHold(unsigned(sampleRate*kMiniEQFlatHoldInSec))
+,			m_flatCountdown(m_flatHold)
 		{
 			SetBiquads();
 		}
@@ -44,30 +68,27 @@ namespace SFM
 
 		void SetTargetdBs(float bassdB, float trebledB, float middB = 0.f);
 
+		// Process block (in place)
+		void Process(float *pLeft, float *pRight, unsigned numSamples);
+
 		SFM_INLINE void Apply(float &sampleL, float &sampleR)
 		{
-			SetBiquads();
-
-			if (true == m_withMid)
+			if (true == Update())
 			{
-				m_midPeak.process(sampleL, sampleR); // First push or pull MID freq.
-			}
-			
-			float loL = sampleL, loR = sampleR;
-			m_bassShelf.process(loL, loR);
+				sampleL *= kMiniEQFlatGain;
+				sampleR *= kMiniEQFlatGain;
 
-			float hiL = sampleL, hiR = sampleR;
-			m_trebleShelf.process(hiL, hiR);
+				return;
+			}
 
-			// Not sure if this is right at all, I'll keep the ticket open, but it does the trick for now
-			sampleL = (loL+hiL)*kNormalGainAtCutoff;
-			sampleR = (loR+hiR)*kNormalGainAtCutoff;
+			Filter(sampleL, sampleR);
 		}
 		
 		// Code duplication, but what are we going to do about it outside of a huge overhaul?
 		SFM_INLINE float ApplyMono(float sample)
 		{
-			SetBiquads();
+			if (true == Update())
+				return sample*kMiniEQFlatGain;
 
 			if (true == m_withMid)
 				m_midPeak.processMono(sample);
@@ -95,8 +116,70 @@ namespace SFM
 		InterpolatedParameter<kLinInterpolate, false> m_bassdB;
 		InterpolatedParameter<kLinInterpolate, false> m_trebledB;
 		InterpolatedParameter<kLinInterpolate, false> m_middB;
+
+		// Samples left until bypass (if flat)
+		const unsigned m_flatHold;
+		unsigned m_flatCountdown;
+
+		SFM_INLINE bool IsSettled() const
+		{
+			return true == m_bassdB.IsDone() && true == m_trebledB.IsDone() && (false == m_withMid || true == m_middB.IsDone());
+		}
+
+		SFM_INLINE bool IsFlat() const
+		{
+			return kMiniEQFlatdB == m_bassdB.Get() && kMiniEQFlatdB == m_trebledB.Get() && (false == m_withMid || kMiniEQFlatdB == m_middB.Get());
+		}
+
+		// Call once per sample; updates biquads (whilst interpolating), returns true if bypassed
+		SFM_INLINE bool Update()
+		{
+			if (false == IsSettled())
+			{
+				// Coming out of bypass?
+				if (0 == m_flatCountdown)
+					ResetBiquads();
+
+				m_flatCountdown = m_flatHold;
+
+				UpdateBiquads();
+
+				return false;
+			}
+
+			if (false == IsFlat())
+				return false;
+
+			if (m_flatCountdown > 0)
+			{
+				--m_flatCountdown;
+				return false;
+			}
+
+			return true;
+		}
+
+		SFM_INLINE void Filter(float &sampleL, float &sampleR)
+		{
+			if (true == m_withMid)
+			{
+				m_midPeak.process(sampleL, sampleR); // First push or pull MID freq.
+			}
+			
+			float loL = sampleL, loR = sampleR;
+			m_bassShelf.process(loL, loR);
+
+			float hiL = sampleL, hiR = sampleR;
+			m_trebleShelf.process(hiL, hiR);
+
+			// Not sure if this is right at all, I'll keep the ticket open, but it does the trick for now
+			sampleL = (loL+hiL)*kNormalGainAtCutoff;
+			sampleR = (loR+hiR)*kNormalGainAtCutoff;
+		}
+
+		// Filter() for 'numSamples' samples, gains must be settled
+		void FilterSettled(float *pLeft, float *pRight, unsigned numSamples);
 		
-		// Only called if necessary
 		SFM_INLINE void SetBiquads()
 		{
 			m_bassShelf.setBiquad(bq_type_lowshelf, m_bassFc, 0.f, m_bassdB.Sample());        // Bass
@@ -106,6 +189,25 @@ namespace SFM
 			if (true == m_withMid)
 				m_midPeak.setBiquad(bq_type_peak, m_midFc, kMidQ, m_middB.Sample());
 		}
+
+		SFM_INLINE void UpdateBiquads()
+		{
+			if (false == m_bassdB.IsDone())
+				m_bassShelf.setBiquad(bq_type_lowshelf, m_bassFc, 0.f, m_bassdB.Sample());
+
+			if (false == m_trebledB.IsDone())
+				m_trebleShelf.setBiquad(bq_type_highshelf, m_trebleFc, 0.f, m_trebledB.Sample());
+
+			if (true == m_withMid && false == m_middB.IsDone())
+				m_midPeak.setBiquad(bq_type_peak, m_midFc, kMidQ, m_middB.Sample());
+		}
+
+		// Drops filter state, tails are inaudible by the time the filters are bypassed
+		SFM_INLINE void ResetBiquads()
+		{
+			m_bassShelf.setState(0.f, 0.f, 0.f, 0.f);
+			m_trebleShelf.setState(0.f, 0.f, 0.f, 0.f);
+			m_midPeak.setState(0.f, 0.f, 0.f, 0.f);
+		}
 	};
 }
-
@@ -0,0 +1,99 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Multi-timbral engine (a set of Bison instances, "parts", on one thread pool).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include <chrono>
+
+#include "synth-multi-timbral.h"
+
+namespace SFM
+{
+	MultiTimbral::MultiTimbral(unsigned numParts /* = kMaxMultiTimbralParts */, unsigned numWorkers /* = kAutoNumWorkers */) :
+		m_numParts(std::min<unsigned>(numParts, kMaxMultiTimbralParts))
+	{
+		SFM_ASSERT(numParts > 0 && numParts <= kMaxMultiTimbralParts);
+
+		// Parts render their voices on whichever thread runs them
+		for (unsigned iPart = 0; iPart < m_numParts; ++iPart)
+		{
+			m_parts[iPart] = new Bison(0);
+			m_partOrder[iPart] = iPart;
+		}
+
+		m_threadPool = new ThreadPool(numWorkers);
+
+		Log("Multi-timbral engine initialized with %u part(s)", m_numParts);
+	}
+
+	MultiTimbral::~MultiTimbral()
+	{
+		delete m_threadPool;
+		m_threadPool = nullptr;
+
+		for (unsigned iPart = 0; iPart < m_numParts; ++iPart)
+		{
+			delete m_parts[iPart];
+			m_parts[iPart] = nullptr;
+		}
+	}
+
+	void MultiTimbral::OnSetSamplingProperties(unsigned sampleRate, unsigned samplesPerBlock)
+	{
+		for (unsigned iPart = 0; iPart < m_numParts; ++iPart)
+		{
+			m_parts[iPart]->OnSetSamplingProperties(sampleRate, samplesPerBlock);
+
+			m_partTime[iPart] = 0.f;
+			m_partOrder[iPart] = iPart;
+		}
+	}
+
+	/* static */ void MultiTimbral::PartRenderThread(void *pContext, unsigned iJob, unsigned iThread)
+	{
+		SFM_ASSERT(nullptr != pContext);
+		PartThreadContext &context = *reinterpret_cast<PartThreadContext *>(pContext);
+
+		(void) iThread;
+
+		MultiTimbral *pInst = context.pInst;
+		SFM_ASSERT(nullptr != pInst);
+
+		const unsigned iPart = pInst->m_partOrder[iJob];
+
+		const auto start = std::chrono::steady_clock::now();
+
+		// Voices, then post-pass
+		pInst->m_parts[iPart]->Render(context.numSamples, context.ppLeft[iPart], context.ppRight[iPart]);
+
+		const float elapsed = std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now()-start).count();
+
+		// Smoothed a little, a thread can always get preempted
+		float &partTime = pInst->m_partTime[iPart];
+		partTime = (0.f == partTime) ? elapsed : lerpf<float>(partTime, elapsed, 0.5f);
+	}
+
+	void MultiTimbral::Render(unsigned numSamples, float * const *ppLeft, float * const *ppRight)
+	{
+		SFM_ASSERT(nullptr != ppLeft && nullptr != ppRight);
+
+		// Render() must not allocate (only checked if SFM_DETECT_RENDER_ALLOCATIONS is defined)
+		NoAllocationScope noAllocation;
+
+		// Heaviest parts first (as measured last time), so that lighter ones fill up the gaps at the end
+		std::sort(m_partOrder, m_partOrder+m_numParts, [this](unsigned left, unsigned right) -> bool
+		{
+			return m_partTime[left] > m_partTime[right];
+		});
+
+		PartThreadContext context;
+		context.pInst = this;
+		context.numSamples = numSamples;
+		context.ppLeft = ppLeft;
+		context.ppRight = ppRight;
+
+		m_threadPool->Run(PartRenderThread, &context, m_numParts);
+	}
+}
@@ -0,0 +1,77 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Multi-timbral engine (a set of Bison instances, "parts", on one thread pool).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Calling Render() on 16 instances, one after the other, leaves all but one core idle (or has each instance
+	fight over cores with it's own pool); instead this object owns the parts and renders them in parallel.
+
+	- Each part is a job on a shared ThreadPool, so threads pick up whatever part is left
+	- A job renders a part's voices and then it's post-pass on the same thread, which keeps that order without
+	  any synchronization (the parts themselves don't use threads)
+	- Parts are handed out heaviest first (as measured in previous blocks), so the slowest part doesn't end up last
+	- Tables (fast cosine, MIDI frequency LUT, supersaw detune) are global and thus shared by all parts anyway; they're
+	  read-only whilst rendering
+	- The random generator (noise, S&H, auto-wah vox et cetera) is not shared: each thread has it's own state (see
+	  synth-random.cpp), so parts can run side by side without racing on it
+
+	Use GetPart() to access a part (patch, events et cetera) as you would a single Bison instance.
+*/
+
+#pragma once
+
+#include "FM_BISON.h"
+
+namespace SFM
+{
+	// Max. number of parts (one per MIDI channel)
+	constexpr unsigned kMaxMultiTimbralParts = 16;
+
+	class MultiTimbral
+	{
+	public:
+		// 'numWorkers' - number of worker threads (on top of the calling one), by default the number of cores minus one
+		MultiTimbral(unsigned numParts = kMaxMultiTimbralParts, unsigned numWorkers = kAutoNumWorkers);
+		~MultiTimbral();
+
+		// Called by JUCE's prepareToPlay(), see Bison::OnSetSamplingProperties()
+		void OnSetSamplingProperties(unsigned sampleRate, unsigned samplesPerBlock);
+
+		unsigned GetNumParts() const
+		{
+			return m_numParts;
+		}
+
+		Bison &GetPart(unsigned iPart)
+		{
+			SFM_ASSERT(iPart < m_numParts);
+			return *m_parts[iPart];
+		}
+
+		// Render number of samples for each part to it's own 2 channels ('ppLeft[iPart]', 'ppRight[iPart]')
+		// Controller values are those posted as events (see Bison::Post*())
+		void Render(unsigned numSamples, float * const *ppLeft, float * const *ppRight);
+
+	private:
+		struct PartThreadContext
+		{
+			MultiTimbral *pInst;
+			unsigned numSamples;
+			float * const *ppLeft;
+			float * const *ppRight;
+		};
+
+		// Thread pool job: renders a single part (in order of m_partOrder)
+		static void PartRenderThread(void *pContext, unsigned iJob, unsigned iThread);
+
+		unsigned m_numParts;
+		Bison *m_parts[kMaxMultiTimbralParts] = { nullptr };
+
+		// Measured render time (nanoseconds) per part & the order in which they're handed out
+		float m_partTime[kMaxMultiTimbralParts] = { 0.f };
+		unsigned m_partOrder[kMaxMultiTimbralParts];
+
+		ThreadPool *m_threadPool = nullptr;
+	};
+}
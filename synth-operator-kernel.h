@@ -0,0 +1,187 @@
+/*
+	FM. BISON hybrid FM synthesis -- Vectorized (SSE2) operator kernel.
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Within a single sample all operators only read modulation (and feedback) of the previous sample, so they
+	can be evaluated side by side; Voice::Sample() gathers the operators that qualify (see Voice::PostInitialize())
+	into lanes, this kernel does the math and Voice::Sample() writes the results back.
+
+	- Only plain sine operators without filters qualify, the rest takes the scalar path
+	- 6 operators fit in 2 SSE registers; AVX2 would fit them in 1 but since gathering and scattering operator
+	  state is scalar anyway the gain would be marginal, so SSE2 (which every x64 CPU has) it is
+	- SSE2 has no gather, so the sine table lookup is done per lane, using the exact same function as the scalar path
+	- Results are bit-identical to the scalar path, so they can be A/B'd (define SFM_DISABLE_SIMD_OPERATORS)
+*/
+
+#pragma once
+
+#include "synth-global.h"
+
+#if !defined(SFM_DISABLE_SIMD_OPERATORS) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define SFM_SIMD_OPERATORS
+	#include <emmintrin.h>
+#endif
+
+#include "synth-stateless-oscillators.h"
+#include "synth-distort.h"
+
+namespace SFM
+{
+	// Number of operators rounded up to SSE register width
+	constexpr unsigned kOperatorLanes = (kNumOperators+3) & ~3;
+
+	// Operators in structure-of-arrays form; Voice::Sample() fills in the input
+	struct alignas(16) OperatorLanes
+	{
+		// Input
+		float phase[kOperatorLanes];        // Current phase [0..1], advanced by OscillateOperatorLanes()
+		float pitch[kOperatorLanes];        // Phase increment (including vibrato)
+		float phaseShift[kOperatorLanes];   // Modulation & feedback (zero or positive)
+		float tremolo[kOperatorLanes];      // LFO*ampMod
+		float envelope[kOperatorLanes];
+		float squarepusher[kOperatorLanes]; // Handled per lane (scalar), only if non-zero
+		float index[kOperatorLanes];
+		float amplitude[kOperatorLanes];
+		float feedback[kOperatorLanes];     // Updated by OutputOperatorLanes()
+		float feedbackAmt[kOperatorLanes];
+		float panning[kOperatorLanes];      // Clamped [0..1]
+		int32_t carrier[kOperatorLanes];    // All bits set if carrier, zero if not
+
+		// Intermediate & output
+		float modulated[kOperatorLanes];    // Modulated phase
+		float sample[kOperatorLanes];
+		float modSample[kOperatorLanes];    // For modulation (index applied)
+		float gain[kOperatorLanes];         // For gain envelope
+		float outL[kOperatorLanes];         // Carrier output (zero if not a carrier)
+		float outR[kOperatorLanes];         //
+	};
+
+#if defined(SFM_SIMD_OPERATORS)
+
+	// Zero unused lanes of the last register; returns number of lanes to process
+	SFM_INLINE static unsigned PadOperatorLanes(OperatorLanes &lanes, unsigned numLanes)
+	{
+		const unsigned numPadded = (numLanes+3) & ~3;
+
+		for (unsigned iLane = numLanes; iLane < numPadded; ++iLane)
+		{
+			lanes.phase[iLane] = lanes.pitch[iLane] = lanes.phaseShift[iLane] = 0.f;
+			lanes.tremolo[iLane] = lanes.envelope[iLane] = lanes.squarepusher[iLane] = 0.f;
+			lanes.index[iLane] = lanes.amplitude[iLane] = 0.f;
+			lanes.feedback[iLane] = lanes.feedbackAmt[iLane] = lanes.panning[iLane] = 0.f;
+			lanes.carrier[iLane] = 0;
+		}
+
+		return numPadded;
+	}
+
+	// Phase accumulate, phase modulation, sine, tremolo & envelope
+	SFM_INLINE static void OscillateOperatorLanes(OperatorLanes &lanes, unsigned numLanes, float modulation)
+	{
+		SFM_ASSERT(0 == (numLanes & 3));
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one  = _mm_set1_ps(1.f);
+
+		for (unsigned iLane = 0; iLane < numLanes; iLane += 4)
+		{
+			const __m128 phase = _mm_load_ps(lanes.phase+iLane);
+			const __m128 pitch = _mm_load_ps(lanes.pitch+iLane);
+			const __m128 shift = _mm_load_ps(lanes.phaseShift+iLane);
+
+			// Modulated phase: truncation equals fmodf(x, 1.f) (exactly) since the sum is always positive
+			const __m128 shifted   = _mm_add_ps(phase, shift);
+			const __m128 wrapped   = _mm_sub_ps(shifted, _mm_cvtepi32_ps(_mm_cvttps_epi32(shifted)));
+			const __m128 noShift   = _mm_cmpeq_ps(shift, zero);
+			const __m128 modulated = _mm_or_ps(_mm_and_ps(noShift, phase), _mm_andnot_ps(noShift, wrapped));
+			_mm_store_ps(lanes.modulated+iLane, modulated);
+
+			// Advance phase (like Phase::Sample())
+			const __m128 advanced = _mm_add_ps(phase, pitch);
+			const __m128 wrap = _mm_and_ps(_mm_cmpge_ps(advanced, one), one);
+			_mm_store_ps(lanes.phase+iLane, _mm_sub_ps(advanced, wrap));
+		}
+
+		// Sine
+		for (unsigned iLane = 0; iLane < numLanes; ++iLane)
+			lanes.sample[iLane] = oscSine(lanes.modulated[iLane]);
+
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+		const __m128 modWet   = _mm_set1_ps(modulation);
+		const __m128 modDry   = _mm_set1_ps(1.f-modulation);
+
+		for (unsigned iLane = 0; iLane < numLanes; iLane += 4)
+		{
+			__m128 sample = _mm_load_ps(lanes.sample+iLane);
+
+			// LFO tremolo
+			const __m128 tremolo = _mm_sub_ps(one, _mm_andnot_ps(signMask, _mm_load_ps(lanes.tremolo+iLane)));
+			sample = _mm_add_ps(_mm_mul_ps(sample, modDry), _mm_mul_ps(_mm_mul_ps(sample, tremolo), modWet));
+
+			// Apply envelope
+			sample = _mm_mul_ps(sample, _mm_load_ps(lanes.envelope+iLane));
+
+			_mm_store_ps(lanes.sample+iLane, sample);
+		}
+
+		// Apply "Squarepusher" distortion
+		for (unsigned iLane = 0; iLane < numLanes; ++iLane)
+		{
+			const float amount = lanes.squarepusher[iLane];
+			if (0.f != amount)
+			{
+				const float sample = lanes.sample[iLane];
+				const float squared = Squarepusher(sample, amount);
+				lanes.sample[iLane] = lerpf<float>(sample, squared, amount);
+			}
+		}
+	}
+
+	// Modulation index, amplitude, gain envelope input, feedback & panning
+	SFM_INLINE static void OutputOperatorLanes(OperatorLanes &lanes, unsigned numLanes, float ampBend)
+	{
+		SFM_ASSERT(0 == (numLanes & 3));
+
+		const __m128 one      = _mm_set1_ps(1.f);
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+		const __m128 epsilon  = _mm_set1_ps(kEpsilon);
+		const __m128 bend     = _mm_set1_ps(ampBend);
+		const __m128 quarter  = _mm_set1_ps(0.25f);
+		const __m128 decay    = _mm_set1_ps(0.995f);
+
+		for (unsigned iLane = 0; iLane < numLanes; iLane += 4)
+		{
+			const __m128 index   = _mm_load_ps(lanes.index+iLane);
+			const __m128 carrier = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i *>(lanes.carrier+iLane)));
+
+			__m128 sample = _mm_load_ps(lanes.sample+iLane);
+
+			// Store sample for modulation, with modulation index applied
+			const __m128 modSample = _mm_mul_ps(sample, index);
+			_mm_store_ps(lanes.modSample+iLane, modSample);
+
+			// Apply (linear) amplitude to sample (including possible 'bend')
+			sample = _mm_mul_ps(sample, _mm_mul_ps(_mm_load_ps(lanes.amplitude+iLane), bend));
+
+			// Gain envelope input: carrier as is, modulator normalized
+			const __m128 absSample = _mm_andnot_ps(signMask, sample);
+			const __m128 normMod = _mm_div_ps(_mm_andnot_ps(signMask, modSample), _mm_add_ps(epsilon, index));
+			_mm_store_ps(lanes.gain+iLane, _mm_or_ps(_mm_and_ps(carrier, sample), _mm_andnot_ps(carrier, normMod)));
+
+			// Update feedback
+			const __m128 feedback = _mm_load_ps(lanes.feedback+iLane);
+			const __m128 feedbackAmt = _mm_load_ps(lanes.feedbackAmt+iLane);
+			_mm_store_ps(lanes.feedback+iLane, _mm_mul_ps(quarter, _mm_add_ps(_mm_mul_ps(feedback, decay), _mm_mul_ps(absSample, feedbackAmt))));
+
+			// Square law panning
+			const __m128 panning = _mm_load_ps(lanes.panning+iLane);
+			const __m128 outL = _mm_mul_ps(sample, _mm_sqrt_ps(_mm_sub_ps(one, panning)));
+			const __m128 outR = _mm_mul_ps(sample, _mm_sqrt_ps(panning));
+			_mm_store_ps(lanes.outL+iLane, _mm_and_ps(carrier, outL));
+			_mm_store_ps(lanes.outR+iLane, _mm_and_ps(carrier, outR));
+		}
+	}
+
+#endif
+}
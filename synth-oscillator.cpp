@@ -10,7 +10,22 @@
 
 namespace SFM
 {
-	void Oscillator::Initialize(Waveform form, float frequency, unsigned sampleRate, float phaseShift, float supersawDetune /* = 0.f */, float supersawMix /* = 0.f */)
+	// Band-limited waveforms that can be taken from a wavetable
+	static WavetableForm GetWavetableForm(Oscillator::Waveform form)
+	{
+		switch (form)
+		{
+		case Oscillator::kPolyTriangle:      return kWavetableTriangle;
+		case Oscillator::kPolySquare:        return kWavetableSquare;
+		case Oscillator::kPolySaw:           return kWavetableSaw;
+		case Oscillator::kPolyRamp:          return kWavetableRamp;
+		case Oscillator::kPolyRectifiedSine: return kWavetableRectifiedSine;
+		case Oscillator::kPolyRectangle:     return kWavetableRectangle;
+		default:                             return kNumWavetableForms;
+		}
+	}
+
+	void Oscillator::Initialize(Waveform form, float frequency, unsigned sampleRate, float phaseShift, float supersawDetune /* = 0.f */, float supersawMix /* = 0.f */, Engine engine /* = kPolyBLEP */)
 	{
 		switch (form)
 		{
@@ -35,6 +50,10 @@ namespace SFM
 		}		
 
 		m_form = form;
+
+		m_wavetableForm = (kWavetable == engine) ? GetWavetableForm(form) : kNumWavetableForms;
+		m_wavetable = nullptr;
+		m_wavetablePitch = -1.f;
 	}
 
 	float Oscillator::Sample(float phaseShift)
@@ -76,27 +95,27 @@ namespace SFM
 				break;
 				
 			case kPolyTriangle:
-				signal = oscPolyTriangle(modulated, pitch);
+				signal = (kNumWavetableForms == m_wavetableForm) ? oscPolyTriangle(modulated, pitch) : SampleWavetable(modulated, pitch);
 				break;
 
 			case kPolySquare:
-				signal = oscPolySquare(modulated, pitch);
+				signal = (kNumWavetableForms == m_wavetableForm) ? oscPolySquare(modulated, pitch) : SampleWavetable(modulated, pitch);
 				break;
 
 			case kPolySaw:
-				signal = oscPolySaw(modulated, pitch);
+				signal = (kNumWavetableForms == m_wavetableForm) ? oscPolySaw(modulated, pitch) : SampleWavetable(modulated, pitch);
 				break;
 
 			case kPolyRamp:
-				signal = oscPolyRamp(modulated, pitch);
+				signal = (kNumWavetableForms == m_wavetableForm) ? oscPolyRamp(modulated, pitch) : SampleWavetable(modulated, pitch);
 				break;
 
 			case kPolyRectifiedSine:
-				signal = oscPolyRectifiedSine(modulated, pitch);
+				signal = (kNumWavetableForms == m_wavetableForm) ? oscPolyRectifiedSine(modulated, pitch) : SampleWavetable(modulated, pitch);
 				break;
 
 			case kPolyRectangle:
-				signal = oscPolyRectangle(modulated, pitch, defaultDuty);
+				signal = (kNumWavetableForms == m_wavetableForm) ? oscPolyRectangle(modulated, pitch, defaultDuty) : SampleWavetable(modulated, pitch);
 				break;
 
 			case kBump:
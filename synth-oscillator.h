@@ -21,6 +21,7 @@
 #include "synth-pink-noise.h"
 #include "synth-sample-and-hold.h"
 #include "synth-supersaw.h"
+#include "synth-wavetable.h"
 
 namespace SFM
 {
@@ -68,10 +69,22 @@ namespace SFM
 			kSampleAndHold
 		};
 
+		// Implementation of band-limited kPoly... waveforms
+		enum Engine
+		{
+			kPolyBLEP,
+			kWavetable // See synth-wavetable.h
+		};
+
 	private:
 		/* const */ Waveform m_form;
 		Phase m_phase;
 
+		// Wavetable (if m_wavetableForm isn't kNumWavetableForms), level is selected by pitch
+		WavetableForm m_wavetableForm = kNumWavetableForms;
+		const float *m_wavetable = nullptr;
+		float m_wavetablePitch = -1.f;
+
 		// Autonomous oscillators
 		PinkNoise     m_pinkNoise;
 		SampleAndHold m_sampleAndHold;
@@ -87,7 +100,7 @@ namespace SFM
 			Initialize(kNone, 0.f, sampleRate, 0.0);
 		}
 
-		void Initialize(Waveform form, float frequency, unsigned sampleRate, float phaseShift, float supersawDetune = 0.f, float supersawMix = 0.f);
+		void Initialize(Waveform form, float frequency, unsigned sampleRate, float phaseShift, float supersawDetune = 0.f, float supersawMix = 0.f, Engine engine = kPolyBLEP);
 
 		SFM_INLINE void PitchBend(float bend)
 		{
@@ -137,6 +150,13 @@ namespace SFM
 			m_sampleAndHold.SetSlewRate(rate);
 		}
 
+		// Phase (for the vectorized operator kernel, see synth-operator-kernel.h)
+		SFM_INLINE Phase &GetPhaseObject()
+		{
+			SFM_ASSERT(kSupersaw != m_form);
+			return m_phase;
+		}
+
 		// Supersaw
 		SFM_INLINE Supersaw &GetSupersaw()
 		{
@@ -144,7 +164,24 @@ namespace SFM
 		}
 
 		float Sample(float phaseShift);
+
+	private:
+		SFM_INLINE float SampleWavetable(float phase, float pitch)
+		{
+			SFM_ASSERT(kNumWavetableForms != m_wavetableForm);
+
+			// Only pick another level if pitch changed
+			if (pitch != m_wavetablePitch)
+			{
+				m_wavetable = GetWavetable(m_wavetableForm, GetWavetableLevel(pitch));
+				m_wavetablePitch = pitch;
+			}
+
+			return oscWavetable(m_wavetable, phase);
+		}
 	};
+
+	constexpr Oscillator::Engine kDefOperatorEngine = Oscillator::kPolyBLEP;
 }
 
 #pragma warning(pop)
@@ -0,0 +1,634 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Polyphase half-band oversampler (stereo, 1X to 8X).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include "synth-oversampler.h"
+
+namespace SFM
+{
+	// Design is done in double precision
+	constexpr double kDesignPI = 3.1415926535897932384626433832795;
+
+	// Stopband attenuation & transition width (normalized to the higher rate) of first (steep) and further stages
+	constexpr double kSteepAttenuationdB = 90.0;
+	constexpr double kSteepTransition    = 0.05;  // Passband up to 0.45 of the original rate
+	constexpr double kAttenuationdB      = 70.0;
+	constexpr double kTransition         = 0.25;
+
+	// Max. number of IIR allpass sections per chain (HIIR's sweet spot is 4-6 in total)
+	constexpr unsigned kMaxAllpassSections = 8;
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Kernels
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	// Sum of products of interleaved window & coefficients (2 channels)
+	SFM_INLINE static void DotStereo(const float *pWindow, const float *pCoeffs, unsigned numFloats, float &left, float &right)
+	{
+#if defined(SFM_SIMD_OVERSAMPLER)
+	#if defined(__AVX2__)
+		SFM_ASSERT(0 == (numFloats & 7));
+
+		__m256 sum8 = _mm256_setzero_ps();
+		for (unsigned iFloat = 0; iFloat < numFloats; iFloat += 8)
+			sum8 = _mm256_add_ps(sum8, _mm256_mul_ps(_mm256_loadu_ps(pWindow+iFloat), _mm256_load_ps(pCoeffs+iFloat)));
+
+		__m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+	#else
+		SFM_ASSERT(0 == (numFloats & 7));
+
+		// 2 sums to hide latency
+		__m128 sumA = _mm_setzero_ps(), sumB = _mm_setzero_ps();
+		for (unsigned iFloat = 0; iFloat < numFloats; iFloat += 8)
+		{
+			sumA = _mm_add_ps(sumA, _mm_mul_ps(_mm_loadu_ps(pWindow+iFloat),   _mm_load_ps(pCoeffs+iFloat)));
+			sumB = _mm_add_ps(sumB, _mm_mul_ps(_mm_loadu_ps(pWindow+iFloat+4), _mm_load_ps(pCoeffs+iFloat+4)));
+		}
+
+		__m128 sum = _mm_add_ps(sumA, sumB);
+	#endif
+
+		// Left & right end up in the lower 2 lanes
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+
+		alignas(16) float result[4];
+		_mm_store_ps(result, sum);
+
+		left  = result[0];
+		right = result[1];
+#else
+		float sumL = 0.f, sumR = 0.f;
+		for (unsigned iFloat = 0; iFloat < numFloats; iFloat += 2)
+		{
+			sumL += pWindow[iFloat]*pCoeffs[iFloat];
+			sumR += pWindow[iFloat+1]*pCoeffs[iFloat+1];
+		}
+
+		left  = sumL;
+		right = sumR;
+#endif
+	}
+
+	// Run 4 lanes through a chain of 1st order allpass filters
+	SFM_INLINE static void AllpassChain(float *pLanes /* 4 */, const float *pCoeffs, float *pX, float *pY, unsigned numSections)
+	{
+#if defined(SFM_SIMD_OVERSAMPLER)
+		__m128 lanes = _mm_loadu_ps(pLanes);
+
+		for (unsigned iSection = 0; iSection < numSections; ++iSection)
+		{
+			const unsigned index = iSection*4;
+			const __m128 X = _mm_load_ps(pX+index);
+			const __m128 Y = _mm_load_ps(pY+index);
+			const __m128 result = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(lanes, Y), _mm_load_ps(pCoeffs+index)), X);
+			_mm_store_ps(pX+index, lanes);
+			_mm_store_ps(pY+index, result);
+			lanes = result;
+		}
+
+		_mm_storeu_ps(pLanes, lanes);
+#else
+		for (unsigned iSection = 0; iSection < numSections; ++iSection)
+		{
+			for (unsigned iLane = 0; iLane < 4; ++iLane)
+			{
+				const unsigned index = iSection*4 + iLane;
+				const float result = (pLanes[iLane]-pY[index])*pCoeffs[index] + pX[index];
+				pX[index] = pLanes[iLane];
+				pY[index] = result;
+				pLanes[iLane] = result;
+			}
+		}
+#endif
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Filter design
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	// Zeroth order modified Bessel function of the first kind (for Kaiser window)
+	static double BesselI0(double x)
+	{
+		double sum = 1.0, term = 1.0;
+		for (unsigned iTerm = 1; iTerm < 64; ++iTerm)
+		{
+			const double half = x/(2.0*iTerm);
+			term *= half*half;
+			sum += term;
+
+			if (term < sum*1e-12)
+				break;
+		}
+
+		return sum;
+	}
+
+	void Oversampler::Stage::DesignFIR(double attenuationdB, double transition)
+	{
+		// Kaiser's estimates
+		const double beta = (attenuationdB > 50.0)
+			? 0.1102*(attenuationdB-8.7)
+			: 0.5842*pow(attenuationdB-21.0, 0.4) + 0.07886*(attenuationdB-21.0);
+
+		const double length = (attenuationdB-8.0)/(2.285*2.0*kDesignPI*transition);
+
+		// A half-band FIR is 4K-1 taps long, 2K of which are non-zero (plus the center tap); K is kept even so
+		// that the number of floats (interleaved) fits AVX registers
+		unsigned K = unsigned(ceil((length+1.0)/4.0));
+		K += K & 1;
+
+		m_numTaps = 2*K;
+
+		const unsigned numFloats = m_numTaps*2;
+		m_pCoeffs       = reinterpret_cast<float *>(mallocAligned(numFloats*sizeof(float), 32));
+		m_pUpHist       = reinterpret_cast<float *>(mallocAligned(2*numFloats*sizeof(float), 32));
+		m_pDownHistEven = reinterpret_cast<float *>(mallocAligned(2*numFloats*sizeof(float), 32));
+		m_pDownHistOdd  = reinterpret_cast<float *>(mallocAligned(2*numFloats*sizeof(float), 32));
+
+		// Windowed sinc (cutoff at a quarter of the rate): odd offsets from the center only, the center tap is 0.5
+		const double center = double(m_numTaps-1);
+		const double I0Beta = BesselI0(beta);
+
+		double taps[2*kMaxOversamplingStages*64]; // Plenty
+		SFM_ASSERT(m_numTaps <= sizeof(taps)/sizeof(double));
+
+		double sum = 0.0;
+		for (unsigned iTap = 0; iTap < m_numTaps; ++iTap)
+		{
+			const double offset = 2.0*iTap - center;
+			const double ratio  = offset/center;
+			const double window = BesselI0(beta*sqrt(1.0 - ratio*ratio))/I0Beta;
+
+			taps[iTap] = window*sin(kDesignPI*offset*0.5)/(kDesignPI*offset);
+			sum += taps[iTap];
+		}
+
+		// Normalize (unity gain at DC)
+		for (unsigned iTap = 0; iTap < m_numTaps; ++iTap)
+		{
+			const float tap = float(0.5*taps[iTap]/sum);
+			m_pCoeffs[iTap*2] = m_pCoeffs[iTap*2 + 1] = tap;
+		}
+
+		// Center tap, twice
+		m_latency = 2.f*(m_numTaps-1);
+
+		// Span
+		m_settleTime = m_numTaps;
+	}
+
+	/*
+		Polyphase IIR half-band, after Laurent de Soras' HIIR (WTFPL):
+		coefficients come from an elliptic prototype given the transition band & attenuation.
+	*/
+
+	static void CalcTransitionParameters(double &k, double &q, double transition)
+	{
+		k = tan((1.0 - transition*2.0)*kDesignPI/4.0);
+		k *= k;
+
+		const double kksqrt = pow(1.0 - k*k, 0.25);
+		const double e  = 0.5*(1.0-kksqrt)/(1.0+kksqrt);
+		const double e2 = e*e;
+		const double e4 = e2*e2;
+
+		q = e*(1.0 + e4*(2.0 + e4*(15.0 + 150.0*e4)));
+	}
+
+	static double CalcAccNum(double q, int order, int c)
+	{
+		double acc = 0.0, term;
+		int iTerm = 0;
+
+		do
+		{
+			term = pow(q, double(iTerm*(iTerm+1))) * sin((iTerm*2 + 1)*c*kDesignPI/order);
+			acc += (iTerm & 1) ? -term : term;
+			++iTerm;
+		}
+		while (fabs(term) > 1e-100);
+
+		return acc;
+	}
+
+	static double CalcAccDen(double q, int order, int c)
+	{
+		double acc = 0.0, term;
+		int iTerm = 1;
+
+		do
+		{
+			term = pow(q, double(iTerm*iTerm)) * cos(iTerm*2*c*kDesignPI/order);
+			acc += (iTerm & 1) ? -term : term;
+			++iTerm;
+		}
+		while (fabs(term) > 1e-100);
+
+		return acc;
+	}
+
+	void Oversampler::Stage::DesignIIR(double attenuationdB, double transition)
+	{
+		double k, q;
+		CalcTransitionParameters(k, q, transition);
+
+		// Order
+		const double attenuation = pow(10.0, -attenuationdB/10.0);
+		const double a = attenuation/(1.0-attenuation);
+
+		int order = int(ceil(log(a*a/16.0)/log(q)));
+		order += 1 - (order & 1); // Odd
+		order = std::max<int>(3, order);
+
+		// Number of coefficients, split evenly over both chains
+		unsigned numCoeffs = (order-1)/2;
+		numCoeffs += numCoeffs & 1;
+		numCoeffs = std::min<unsigned>(numCoeffs, kMaxAllpassSections*2);
+
+		order = numCoeffs*2 + 1;
+
+		m_numSections = numCoeffs/2;
+
+		// Coefficients, up X & Y and down X & Y
+		const unsigned numFloats = m_numSections*4;
+		m_pAllpass = reinterpret_cast<float *>(mallocAligned(5*numFloats*sizeof(float), 16));
+
+		double latencyA = 0.0, latencyB = 0.0;
+		double maxCoeff = 0.0;
+
+		for (unsigned iCoeff = 0; iCoeff < numCoeffs; ++iCoeff)
+		{
+			const int c = int(iCoeff)+1;
+			const double num  = CalcAccNum(q, order, c) * pow(q, 0.25);
+			const double den  = CalcAccDen(q, order, c) + 0.5;
+			const double ww   = num/den;
+			const double wwsq = ww*ww;
+			const double x    = sqrt((1.0 - wwsq*k)*(1.0 - wwsq/k))/(1.0 + wwsq);
+			const double coeff = (1.0-x)/(1.0+x);
+
+			// Group delay at DC (each section works on every other sample at the higher rate)
+			const double delay = 2.0*(1.0-coeff)/(1.0+coeff);
+
+			// Alternating between chain A (lanes 0 & 1) and B (lanes 2 & 3)
+			const unsigned iSection = iCoeff >> 1;
+			const unsigned iLane = (iCoeff & 1) << 1;
+
+			m_pAllpass[iSection*4 + iLane] = m_pAllpass[iSection*4 + iLane + 1] = float(coeff);
+
+			maxCoeff = std::max<double>(maxCoeff, coeff);
+
+			if (0 == (iCoeff & 1))
+				latencyA += delay;
+			else
+				latencyB += delay;
+		}
+
+		// Chain B is a sample late when upsampling, but decimation takes the odd sample (a sample early)
+		const double latency = 0.5*(latencyA + latencyB + 1.0);
+		m_latency = float(2.0*latency - 1.0);
+
+		// Slowest section decays by 60dB (each section runs at the lower rate)
+		m_settleTime = 1 + unsigned(ceil(log(1e-3)/log(std::max<double>(maxCoeff, 1e-3))));
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Stage
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	Oversampler::Stage::Stage(Design design, bool isSteep) :
+		m_design(design)
+	{
+		const double attenuationdB = (true == isSteep) ? kSteepAttenuationdB : kAttenuationdB;
+		const double transition    = (true == isSteep) ? kSteepTransition    : kTransition;
+
+		if (kFIR == m_design)
+			DesignFIR(attenuationdB, transition);
+		else
+			DesignIIR(attenuationdB, transition);
+
+		Reset();
+	}
+
+	Oversampler::Stage::~Stage()
+	{
+		freeAligned(m_pCoeffs);
+		freeAligned(m_pUpHist);
+		freeAligned(m_pDownHistEven);
+		freeAligned(m_pDownHistOdd);
+		freeAligned(m_pAllpass);
+	}
+
+	void Oversampler::Stage::Reset()
+	{
+		if (kFIR == m_design)
+		{
+			const size_t histSize = 2*m_numTaps*2*sizeof(float);
+			memset(m_pUpHist, 0, histSize);
+			memset(m_pDownHistEven, 0, histSize);
+			memset(m_pDownHistOdd, 0, histSize);
+
+			m_upPos = m_downPos = 0;
+		}
+		else
+		{
+			// Leave coefficients be
+			const unsigned numFloats = m_numSections*4;
+			memset(m_pAllpass+numFloats, 0, 4*numFloats*sizeof(float));
+		}
+	}
+
+	void Oversampler::Stage::Up(const float *pIn, float *pOut, unsigned numFrames)
+	{
+		if (kFIR == m_design)
+			UpFIR(pIn, pOut, numFrames);
+		else
+			UpIIR(pIn, pOut, numFrames);
+	}
+
+	void Oversampler::Stage::Down(const float *pIn, float *pOut, unsigned numFrames)
+	{
+		if (kFIR == m_design)
+			DownFIR(pIn, pOut, numFrames);
+		else
+			DownIIR(pIn, pOut, numFrames);
+	}
+
+	void Oversampler::Stage::UpFIR(const float *pIn, float *pOut, unsigned numFrames)
+	{
+		const unsigned numTaps = m_numTaps;
+		const unsigned numFloats = numTaps*2;
+
+		// The center tap only meets the zero-stuffed signal on odd samples: a delay of K frames (in window)
+		const unsigned iDelayed = numTaps; // (numTaps/2)*2
+
+		for (unsigned iFrame = 0; iFrame < numFrames; ++iFrame)
+		{
+			// Write twice, so the window is contiguous
+			float *pWrite = m_pUpHist + m_upPos*2;
+			pWrite[0] = pWrite[numFloats]   = pIn[0];
+			pWrite[1] = pWrite[numFloats+1] = pIn[1];
+
+			if (++m_upPos == numTaps)
+				m_upPos = 0;
+
+			// Oldest first
+			const float *pWindow = m_pUpHist + m_upPos*2;
+
+			float evenL, evenR;
+			DotStereo(pWindow, m_pCoeffs, numFloats, evenL, evenR);
+
+			// Zero-stuffed signal is doubled to keep unity gain
+			pOut[0] = 2.f*evenL;
+			pOut[1] = 2.f*evenR;
+			pOut[2] = pWindow[iDelayed];
+			pOut[3] = pWindow[iDelayed+1];
+
+			pIn  += 2;
+			pOut += 4;
+		}
+	}
+
+	void Oversampler::Stage::DownFIR(const float *pIn, float *pOut, unsigned numFrames)
+	{
+		const unsigned numTaps = m_numTaps;
+		const unsigned numFloats = numTaps*2;
+
+		// Center tap, K frames back (in window)
+		const unsigned iDelayed = numTaps-2; // (numTaps/2 - 1)*2
+
+		for (unsigned iFrame = 0; iFrame < numFrames; ++iFrame)
+		{
+			const unsigned iWrite = m_downPos*2;
+
+			float *pEven = m_pDownHistEven + iWrite;
+			pEven[0] = pEven[numFloats]   = pIn[0];
+			pEven[1] = pEven[numFloats+1] = pIn[1];
+
+			float *pOdd = m_pDownHistOdd + iWrite;
+			pOdd[0] = pOdd[numFloats]   = pIn[2];
+			pOdd[1] = pOdd[numFloats+1] = pIn[3];
+
+			if (++m_downPos == numTaps)
+				m_downPos = 0;
+
+			const float *pEvenWindow = m_pDownHistEven + m_downPos*2;
+			const float *pOddWindow  = m_pDownHistOdd  + m_downPos*2;
+
+			float left, right;
+			DotStereo(pEvenWindow, m_pCoeffs, numFloats, left, right);
+
+			pOut[0] = left  + 0.5f*pOddWindow[iDelayed];
+			pOut[1] = right + 0.5f*pOddWindow[iDelayed+1];
+
+			pIn  += 4;
+			pOut += 2;
+		}
+	}
+
+	void Oversampler::Stage::UpIIR(const float *pIn, float *pOut, unsigned numFrames)
+	{
+		const unsigned numFloats = m_numSections*4;
+		const float *pCoeffs = m_pAllpass;
+		float *pX = m_pAllpass + numFloats;
+		float *pY = m_pAllpass + numFloats*2;
+
+		for (unsigned iFrame = 0; iFrame < numFrames; ++iFrame)
+		{
+			// Chain A yields the first, chain B the second sample
+			pOut[0] = pOut[2] = pIn[0];
+			pOut[1] = pOut[3] = pIn[1];
+
+			AllpassChain(pOut, pCoeffs, pX, pY, m_numSections);
+
+			pIn  += 2;
+			pOut += 4;
+		}
+	}
+
+	void Oversampler::Stage::DownIIR(const float *pIn, float *pOut, unsigned numFrames)
+	{
+		const unsigned numFloats = m_numSections*4;
+		const float *pCoeffs = m_pAllpass;
+		float *pX = m_pAllpass + numFloats*3;
+		float *pY = m_pAllpass + numFloats*4;
+
+		for (unsigned iFrame = 0; iFrame < numFrames; ++iFrame)
+		{
+			// Second sample through chain A, first through chain B
+			alignas(16) float lanes[4] = { pIn[2], pIn[3], pIn[0], pIn[1] };
+
+			AllpassChain(lanes, pCoeffs, pX, pY, m_numSections);
+
+			pOut[0] = 0.5f*(lanes[0]+lanes[2]);
+			pOut[1] = 0.5f*(lanes[1]+lanes[3]);
+
+			pIn  += 4;
+			pOut += 2;
+		}
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Oversampler
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	Oversampler::Oversampler(unsigned numStages, Design design, unsigned maxSamplesPerBlock) :
+		m_numStages(std::min<unsigned>(numStages, kMaxOversamplingStages))
+,		m_maxSamplesPerBlock(maxSamplesPerBlock)
+	{
+		SFM_ASSERT(numStages <= kMaxOversamplingStages);
+		SFM_ASSERT(maxSamplesPerBlock > 0);
+
+		// Only the first stage borders on the audible band
+		for (unsigned iStage = 0; iStage < m_numStages; ++iStage)
+			m_stages[iStage] = new Stage(design, 0 == iStage);
+
+		for (unsigned iRate = 0; iRate <= m_numStages; ++iRate)
+			m_pBuffers[iRate] = reinterpret_cast<float *>(mallocAligned((maxSamplesPerBlock<<iRate)*2*sizeof(float), 16));
+
+		const unsigned maxOversamples = maxSamplesPerBlock<<m_numStages;
+		m_pOverL = reinterpret_cast<float *>(mallocAligned(maxOversamples*sizeof(float), 16));
+		m_pOverR = reinterpret_cast<float *>(mallocAligned(maxOversamples*sizeof(float), 16));
+
+		// Linear phase: pad to a whole number of samples (each stage adds a multiple of a sample at it's input rate)
+		if (kFIR == design && 0 != m_numStages)
+		{
+			const float latency = GetLatency();
+			m_numPadFrames = unsigned((ceilf(latency)-latency)*GetFactor() + 0.5f) % GetFactor();
+			SFM_ASSERT(maxSamplesPerBlock >= m_numPadFrames);
+		}
+	}
+
+	Oversampler::~Oversampler()
+	{
+		for (unsigned iStage = 0; iStage < m_numStages; ++iStage)
+			delete m_stages[iStage];
+
+		for (unsigned iRate = 0; iRate <= m_numStages; ++iRate)
+			freeAligned(m_pBuffers[iRate]);
+
+		freeAligned(m_pOverL);
+		freeAligned(m_pOverR);
+	}
+
+	void Oversampler::Reset()
+	{
+		for (unsigned iStage = 0; iStage < m_numStages; ++iStage)
+			m_stages[iStage]->Reset();
+
+		memset(m_padding, 0, sizeof(m_padding));
+	}
+
+	unsigned Oversampler::Upsample(const float *pLeft, const float *pRight, unsigned numSamples)
+	{
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
+		SFM_ASSERT(numSamples <= m_maxSamplesPerBlock);
+
+		if (0 == m_numStages)
+		{
+			memcpy(m_pOverL, pLeft,  numSamples*sizeof(float));
+			memcpy(m_pOverR, pRight, numSamples*sizeof(float));
+
+			return numSamples;
+		}
+
+		float *pInterleaved = m_pBuffers[0];
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			pInterleaved[iSample*2]   = pLeft[iSample];
+			pInterleaved[iSample*2+1] = pRight[iSample];
+		}
+
+		unsigned numFrames = numSamples;
+		for (unsigned iStage = 0; iStage < m_numStages; ++iStage)
+		{
+			m_stages[iStage]->Up(m_pBuffers[iStage], m_pBuffers[iStage+1], numFrames);
+			numFrames *= 2;
+		}
+
+		pInterleaved = m_pBuffers[m_numStages];
+		for (unsigned iSample = 0; iSample < numFrames; ++iSample)
+		{
+			m_pOverL[iSample] = pInterleaved[iSample*2];
+			m_pOverR[iSample] = pInterleaved[iSample*2+1];
+		}
+
+		return numFrames;
+	}
+
+	void Oversampler::Downsample(float *pLeft, float *pRight, unsigned numSamples)
+	{
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
+		SFM_ASSERT(numSamples <= m_maxSamplesPerBlock);
+
+		if (0 == m_numStages)
+		{
+			memcpy(pLeft,  m_pOverL, numSamples*sizeof(float));
+			memcpy(pRight, m_pOverR, numSamples*sizeof(float));
+
+			return;
+		}
+
+		const unsigned numOversamples = numSamples<<m_numStages;
+
+		float *pInterleaved = m_pBuffers[m_numStages];
+		for (unsigned iSample = 0; iSample < numOversamples; ++iSample)
+		{
+			pInterleaved[iSample*2]   = m_pOverL[iSample];
+			pInterleaved[iSample*2+1] = m_pOverR[iSample];
+		}
+
+		if (0 != m_numPadFrames && 0 != numSamples)
+		{
+			// Delay by a few frames
+			const unsigned numPadFloats = m_numPadFrames*2;
+			float carry[2 << kMaxOversamplingStages];
+			memcpy(carry, pInterleaved + numOversamples*2 - numPadFloats, numPadFloats*sizeof(float));
+			memmove(pInterleaved+numPadFloats, pInterleaved, (numOversamples*2 - numPadFloats)*sizeof(float));
+			memcpy(pInterleaved, m_padding, numPadFloats*sizeof(float));
+			memcpy(m_padding, carry, numPadFloats*sizeof(float));
+		}
+
+		for (unsigned iStage = m_numStages; iStage > 0; --iStage)
+		{
+			m_stages[iStage-1]->Down(m_pBuffers[iStage], m_pBuffers[iStage-1], numSamples<<(iStage-1));
+		}
+
+		pInterleaved = m_pBuffers[0];
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			pLeft[iSample]  = pInterleaved[iSample*2];
+			pRight[iSample] = pInterleaved[iSample*2+1];
+		}
+	}
+
+	float Oversampler::GetLatency() const
+	{
+		// Each stage delays at it's own (higher) rate
+		float latency = 0.f;
+		for (unsigned iStage = 0; iStage < m_numStages; ++iStage)
+			latency += m_stages[iStage]->GetLatency() / float(2 << iStage);
+
+		return latency + float(m_numPadFrames)/GetFactor();
+	}
+
+	unsigned Oversampler::GetSettleTime() const
+	{
+		// Each stage up & down, plus padding
+		float settleTime = float(m_numPadFrames)/GetFactor();
+		for (unsigned iStage = 0; iStage < m_numStages; ++iStage)
+			settleTime += 2.f*m_stages[iStage]->GetSettleTime() / float(1 << iStage);
+
+		return unsigned(ceilf(settleTime));
+	}
+}
@@ -0,0 +1,150 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Polyphase half-band oversampler (stereo, 1X to 8X).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Replaces juce::dsp::Oversampling; each stage doubles (up) or halves (down) the sample rate using a half-band
+	filter, so 1 stage is 2X, 2 stages 4X and 3 stages 8X.
+
+	- kFIR: linear phase (Kaiser windowed sinc); every other tap of a half-band FIR is zero, so after polyphase
+	  decomposition one branch is a pure delay and the other a symmetric FIR at the lower rate
+	- kIIR: minimum latency, 2 parallel chains of 1st order allpass filters (polyphase IIR after Laurent de Soras'
+	  HIIR), the phase is compromised near Nyquist
+	- The first stage is steep (it borders on the audible band), the next ones only have to reject what's left
+	- Channels are interleaved, so a single SSE2 (or AVX2) register holds 2 (or 4) taps of both channels (FIR) or
+	  both allpass chains of both channels (IIR); define SFM_DISABLE_SIMD_OVERSAMPLER to A/B against scalar code
+	- GetLatency() is exact for kFIR, for kIIR it's the group delay at DC
+*/
+
+#pragma once
+
+#include "synth-global.h"
+
+#if !defined(SFM_DISABLE_SIMD_OVERSAMPLER) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define SFM_SIMD_OVERSAMPLER
+	#include <emmintrin.h>
+	#if defined(__AVX2__)
+		#include <immintrin.h>
+	#endif
+#endif
+
+namespace SFM
+{
+	// 8X
+	constexpr unsigned kMaxOversamplingStages = 3;
+
+	class Oversampler
+	{
+	public:
+		enum Design
+		{
+			kFIR, // Linear phase
+			kIIR  // Minimum latency
+		};
+
+		// 'numStages' - 0 (1X, pass-through) to kMaxOversamplingStages
+		Oversampler(unsigned numStages, Design design, unsigned maxSamplesPerBlock);
+		~Oversampler();
+
+		void Reset();
+
+		// Upsample to GetLeft() & GetRight(), returns number of (oversampled) samples
+		unsigned Upsample(const float *pLeft, const float *pRight, unsigned numSamples);
+
+		// Downsample GetLeft() & GetRight() back to 'numSamples' samples
+		void Downsample(float *pLeft, float *pRight, unsigned numSamples);
+
+		SFM_INLINE float *GetLeft() const
+		{
+			return m_pOverL;
+		}
+
+		SFM_INLINE float *GetRight() const
+		{
+			return m_pOverR;
+		}
+
+		SFM_INLINE unsigned GetFactor() const
+		{
+			return 1 << m_numStages;
+		}
+
+		// Up- & downsampling latency (in samples at the original rate), kFIR is padded to a whole number of samples
+		float GetLatency() const;
+
+		// Number of samples (at the original rate) it takes for the filters to forget their state (after Reset())
+		unsigned GetSettleTime() const;
+
+	private:
+		// A single 2X stage (interleaved stereo)
+		class Stage
+		{
+		public:
+			Stage(Design design, bool isSteep);
+			~Stage();
+
+			void Reset();
+
+			// 'numFrames' input frames to twice as many output frames
+			void Up(const float *pIn, float *pOut, unsigned numFrames);
+
+			// 'numFrames' output frames from twice as many input frames
+			void Down(const float *pIn, float *pOut, unsigned numFrames);
+
+			// Of up- plus downsampling (in samples at the higher rate)
+			float GetLatency() const
+			{
+				return m_latency;
+			}
+
+			// Up- or downsampling (in frames at the lower rate)
+			unsigned GetSettleTime() const
+			{
+				return m_settleTime;
+			}
+
+		private:
+			void DesignFIR(double attenuationdB, double transition);
+			void DesignIIR(double attenuationdB, double transition);
+
+			void UpFIR(const float *pIn, float *pOut, unsigned numFrames);
+			void DownFIR(const float *pIn, float *pOut, unsigned numFrames);
+			void UpIIR(const float *pIn, float *pOut, unsigned numFrames);
+			void DownIIR(const float *pIn, float *pOut, unsigned numFrames);
+
+			const Design m_design;
+			float m_latency = 0.f;
+			unsigned m_settleTime = 0;
+
+			// FIR: non-zero taps at the lower rate (2 per channel, interleaved) & histories (twice the
+			// number of taps so that the window is always contiguous)
+			unsigned m_numTaps = 0;
+			float *m_pCoeffs = nullptr;
+			float *m_pUpHist = nullptr;
+			float *m_pDownHistEven = nullptr;
+			float *m_pDownHistOdd = nullptr;
+			unsigned m_upPos = 0, m_downPos = 0;
+
+			// IIR: allpass coefficients & state, 4 lanes per section (chain A left & right, chain B left & right)
+			unsigned m_numSections = 0;
+			float *m_pAllpass = nullptr; // Coefficients, up X & Y, down X & Y
+		};
+
+		const unsigned m_numStages;
+		const unsigned m_maxSamplesPerBlock;
+
+		Stage *m_stages[kMaxOversamplingStages] = { nullptr };
+
+		// Interleaved buffer for each rate (original rate first)
+		float *m_pBuffers[kMaxOversamplingStages+1] = { nullptr };
+
+		// Oversampled signal
+		float *m_pOverL = nullptr;
+		float *m_pOverR = nullptr;
+
+		// Delay (interleaved, at the highest rate) to pad latency to a whole number of samples
+		unsigned m_numPadFrames = 0;
+		float m_padding[2 << kMaxOversamplingStages] = { 0.f };
+	};
+}
@@ -66,6 +66,13 @@ namespace SFM
 		SFM_INLINE float     GetPitch()        const { return m_pitch;      }
 		SFM_INLINE float     Get()             const { return m_phase;      }
 
+		// Used by the vectorized operator kernel, which advances the phase itself (see synth-operator-kernel.h)
+		SFM_INLINE void Set(float phase)
+		{
+			SFM_ASSERT(phase >= 0.f && phase <= 1.f);
+			m_phase = phase;
+		}
+
 		SFM_INLINE float Sample()
 		{
 			const float curPhase = m_phase;
@@ -79,10 +86,10 @@ namespace SFM
 			return curPhase;
 		}
 
-		// Can be used for free running phases
-		SFM_INLINE void Skip(unsigned count)
+		// Can be used for free running phases (in double precision, as 'count' can be huge)
+		SFM_INLINE void Skip(uint64_t count)
 		{
-			m_phase = fmodf(m_phase + m_pitch*count, 1.f);
+			m_phase = float(fmod(m_phase + double(count)*m_pitch, 1.0));
 		}
 	};
 }
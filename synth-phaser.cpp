@@ -0,0 +1,268 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Phaser (8 stereo all-pass stages).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include "synth-phaser.h"
+
+namespace SFM
+{
+	// Sweep LFO filter cutoff (tweaked a little for effect)
+	constexpr float kPhaserSweepCutoffHz = 100.f;
+
+	Phaser::Phaser(unsigned sampleRate, unsigned Nyquist, unsigned maxSamplesPerBlock) :
+		m_sampleRate(sampleRate), m_Nyquist(Nyquist)
+,		m_sweep(sampleRate)
+,		m_sweepLPF(kPhaserSweepCutoffHz/sampleRate)
+	{
+		// Sweep starts at center
+		m_g = fast_tanpif(SVF_CutoffToHz(0.5f, m_Nyquist)/m_sampleRate);
+
+		float Q = kSVFLowestFilterQ; // FIXME: use higher Q?
+
+		for (unsigned iStage = 0; iStage < kNumPhaserStages; ++iStage)
+		{
+			const float k = 1.f/Q;
+
+			// Same for both channels
+			m_k[iStage*2]  = m_k[iStage*2 + 1]  = k;
+			m_m1[iStage*2] = m_m1[iStage*2 + 1] = -2.f*k;
+
+			// Adds a little "space"
+			Q += Q;
+		}
+
+		for (unsigned iLane = 0; iLane < kNumPhaserStages*2; ++iLane)
+			m_ic1eq[iLane] = m_ic2eq[iLane] = 0.f;
+
+		// Allocate buffers
+		m_pL     = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
+		m_pR     = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
+		m_pG     = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
+		m_pWet   = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
+		m_pIndex = reinterpret_cast<unsigned *>(mallocAligned(maxSamplesPerBlock*sizeof(unsigned), 16));
+	}
+
+	Phaser::~Phaser()
+	{
+		freeAligned(m_pL);
+		freeAligned(m_pR);
+		freeAligned(m_pG);
+		freeAligned(m_pWet);
+		freeAligned(m_pIndex);
+	}
+
+	float Phaser::SampleG()
+	{
+		// Sweep LFO (filtered for pleasing effect)
+		const float sweepMod = m_sweepLPF.Apply(oscTriangle(m_sweep.Sample()));
+
+		if (0 == m_countdown)
+		{
+			m_countdown = kPhaserControlRate;
+
+			// Sweep cutoff frequency around center
+			constexpr float range = 0.2f;
+			static_assert(range < 0.5f);
+			const float normCutoff = 0.5f + range*sweepMod;
+
+			const float cutoffHz = SVF_CutoffToHz(normCutoff, m_Nyquist);
+
+			// Keep away from Nyquist, tan() goes to infinity there
+			constexpr float kMaxRatio = 0.4999f;
+			const float targetG = fast_tanpif(std::min<float>(kMaxRatio, cutoffHz/m_sampleRate));
+
+			// Interpolate towards it over next kPhaserControlRate samples
+			m_deltaG = (targetG-m_g)/kPhaserControlRate;
+		}
+
+		--m_countdown;
+
+		m_g += m_deltaG;
+		return m_g;
+	}
+
+	void Phaser::Apply(float *pLeft, float *pRight, unsigned numSamples, InterpolatedParameter<kLinInterpolate, true> &wetness)
+	{
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
+
+		if (true == wetness.IsDone() && 0.f == wetness.Get())
+			return;
+
+		// Gather wet samples
+		unsigned numWet = 0;
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			const float wet = wetness.Sample();
+
+			if (wet > 0.f)
+			{
+				m_pIndex[numWet] = iSample;
+				m_pWet[numWet]   = wet*kMaxChorusPhaserWet;
+				m_pL[numWet]     = pLeft[iSample];
+				m_pR[numWet]     = pRight[iSample];
+				m_pG[numWet]     = SampleG();
+
+				++numWet;
+			}
+		}
+
+		if (0 == numWet)
+			return;
+
+		Cascade(numWet);
+
+		// Add result to dry signal
+		for (unsigned iWet = 0; iWet < numWet; ++iWet)
+		{
+			const unsigned iSample = m_pIndex[iWet];
+			const float wet = m_pWet[iWet];
+
+			pLeft[iSample]  += wet*m_pL[iWet];
+			pRight[iSample] += wet*m_pR[iWet];
+		}
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		All-pass cascade
+
+		Same math as SvfLinearTrapOptimised2::tick() using ALL_PASS_FILTER coefficients (m0 = 1, m1 = -2k, m2 = 0)
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+#if defined(SFM_SIMD_PHASER)
+
+	void Phaser::Cascade(unsigned numSamples)
+	{
+		// Each register holds 2 stages: [stage N L, stage N R, stage N+1 L, stage N+1 R]
+		static_assert(0 == (kNumPhaserStages & 1));
+		constexpr unsigned kNumRegs = kNumPhaserStages/2;
+
+		__m128 k[kNumRegs], m1[kNumRegs], ic1eq[kNumRegs], ic2eq[kNumRegs];
+		__m128i stage[kNumRegs];
+
+		// Output & 'g' of last iteration
+		__m128 out[kNumRegs], g[kNumRegs];
+
+		for (unsigned iReg = 0; iReg < kNumRegs; ++iReg)
+		{
+			k[iReg]     = _mm_load_ps(m_k + iReg*4);
+			m1[iReg]    = _mm_load_ps(m_m1 + iReg*4);
+			ic1eq[iReg] = _mm_load_ps(m_ic1eq + iReg*4);
+			ic2eq[iReg] = _mm_load_ps(m_ic2eq + iReg*4);
+			stage[iReg] = _mm_setr_epi32(iReg*2, iReg*2, iReg*2 + 1, iReg*2 + 1);
+			out[iReg]   = _mm_setzero_ps();
+			g[iReg]     = _mm_setzero_ps();
+		}
+
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 two = _mm_set1_ps(2.f);
+
+		// Stage N processes sample (iIter-N), so the last one is done kNumPhaserStages-1 iterations later
+		const int numIter = int(numSamples + kNumPhaserStages-1);
+		for (int iIter = 0; iIter < numIter; ++iIter)
+		{
+			// Feed first stage (through the upper 2 lanes, see shuffle below)
+			__m128 prevOut = _mm_setzero_ps(), prevG = _mm_setzero_ps();
+			if (iIter < int(numSamples))
+			{
+				prevOut = _mm_setr_ps(0.f, 0.f, m_pL[iIter], m_pR[iIter]);
+				prevG   = _mm_set1_ps(m_pG[iIter]);
+			}
+
+			// Stages that aren't fed (yet, or anymore) keep their state
+			const __m128i iterIdx    = _mm_set1_epi32(iIter);
+			const __m128i iterEndIdx = _mm_set1_epi32(iIter - int(numSamples));
+
+			for (unsigned iReg = 0; iReg < kNumRegs; ++iReg)
+			{
+				// Input is output of previous stage (of last iteration), same goes for it's 'g'
+				const __m128 v0 = _mm_shuffle_ps(prevOut, out[iReg], _MM_SHUFFLE(1, 0, 3, 2));
+				const __m128 curG = _mm_shuffle_ps(prevG, g[iReg], _MM_SHUFFLE(1, 0, 3, 2));
+				prevOut = out[iReg];
+				prevG = g[iReg];
+
+				// Coefficients
+				const __m128 a1 = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(curG, _mm_add_ps(curG, k[iReg]))));
+				const __m128 a2 = _mm_mul_ps(curG, a1);
+				const __m128 a3 = _mm_mul_ps(curG, a2);
+
+				// Tick
+				const __m128 v3 = _mm_sub_ps(v0, ic2eq[iReg]);
+				const __m128 v1 = _mm_add_ps(_mm_mul_ps(a1, ic1eq[iReg]), _mm_mul_ps(a2, v3));
+				const __m128 v2 = _mm_add_ps(_mm_add_ps(ic2eq[iReg], _mm_mul_ps(a2, ic1eq[iReg])), _mm_mul_ps(a3, v3));
+				const __m128 newIc1eq = _mm_sub_ps(_mm_mul_ps(two, v1), ic1eq[iReg]);
+				const __m128 newIc2eq = _mm_sub_ps(_mm_mul_ps(two, v2), ic2eq[iReg]);
+
+				out[iReg] = _mm_add_ps(v0, _mm_mul_ps(m1[iReg], v1));
+				g[iReg] = curG;
+
+				// Active if 0 <= iIter-stage < numSamples
+				const __m128 active = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpgt_epi32(stage[iReg], iterIdx), _mm_cmpgt_epi32(stage[iReg], iterEndIdx)));
+				ic1eq[iReg] = _mm_or_ps(_mm_and_ps(active, newIc1eq), _mm_andnot_ps(active, ic1eq[iReg]));
+				ic2eq[iReg] = _mm_or_ps(_mm_and_ps(active, newIc2eq), _mm_andnot_ps(active, ic2eq[iReg]));
+			}
+
+			// Last stage (upper 2 lanes) is done with sample (iIter-(kNumPhaserStages-1))
+			const int iSample = iIter - int(kNumPhaserStages-1);
+			if (iSample >= 0)
+			{
+				alignas(16) float lastStage[4];
+				_mm_store_ps(lastStage, out[kNumRegs-1]);
+
+				m_pL[iSample] = lastStage[2];
+				m_pR[iSample] = lastStage[3];
+			}
+		}
+
+		for (unsigned iReg = 0; iReg < kNumRegs; ++iReg)
+		{
+			_mm_store_ps(m_ic1eq + iReg*4, ic1eq[iReg]);
+			_mm_store_ps(m_ic2eq + iReg*4, ic2eq[iReg]);
+		}
+	}
+
+#else
+
+	SFM_INLINE static float TickAllpass(float v0, float a1, float a2, float a3, float m1, float &ic1eq, float &ic2eq)
+	{
+		const float v3 = v0 - ic2eq;
+		const float v1 = a1*ic1eq + a2*v3;
+		const float v2 = ic2eq + a2*ic1eq + a3*v3;
+		ic1eq = 2.f*v1 - ic1eq;
+		ic2eq = 2.f*v2 - ic2eq;
+
+		return v0 + m1*v1;
+	}
+
+	void Phaser::Cascade(unsigned numSamples)
+	{
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			const float g = m_pG[iSample];
+
+			float left  = m_pL[iSample];
+			float right = m_pR[iSample];
+
+			for (unsigned iStage = 0; iStage < kNumPhaserStages; ++iStage)
+			{
+				const unsigned iLane = iStage*2;
+
+				const float a1 = 1.f/(1.f + g*(g + m_k[iLane]));
+				const float a2 = g*a1;
+				const float a3 = g*a2;
+
+				left  = TickAllpass(left,  a1, a2, a3, m_m1[iLane],   m_ic1eq[iLane],   m_ic2eq[iLane]);
+				right = TickAllpass(right, a1, a2, a3, m_m1[iLane+1], m_ic1eq[iLane+1], m_ic2eq[iLane+1]);
+			}
+
+			m_pL[iSample] = left;
+			m_pR[iSample] = right;
+		}
+	}
+
+#endif
+}
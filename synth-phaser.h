@@ -0,0 +1,90 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Phaser (8 stereo all-pass stages).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Replaces the 8 SvfLinearTrapOptimised2 all-pass filters PostPass used to update & tick every sample; all stages
+	share the same cutoff (only Q differs, it doubles per stage), so:
+
+	- 'g' is calculated once per kPhaserControlRate samples (using fast_tanpif()) and linearly interpolated in between,
+	  'k' (1/Q) is a constant per stage
+	- A block is processed as a whole: stage N processes sample S whilst stage N+1 processes sample S-1 and so on,
+	  which puts all stages (times 2 channels) side by side in SSE lanes, without adding latency; this takes
+	  kNumPhaserStages-1 extra iterations per block to fill and drain the cascade
+	- Results are bit-identical to the scalar path, so they can be A/B'd (define SFM_DISABLE_SIMD_PHASER)
+*/
+
+#pragma once
+
+#include "synth-global.h"
+
+#if !defined(SFM_DISABLE_SIMD_PHASER) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define SFM_SIMD_PHASER
+	#include <emmintrin.h>
+#endif
+
+#include "synth-phase.h"
+#include "synth-one-pole-filters.h"
+#include "synth-interpolated-parameter.h"
+
+namespace SFM
+{
+	constexpr unsigned kNumPhaserStages = 8;
+
+	// Samples per 'g' calculation
+	constexpr unsigned kPhaserControlRate = 16;
+
+	class Phaser
+	{
+	public:
+		Phaser(unsigned sampleRate, unsigned Nyquist, unsigned maxSamplesPerBlock);
+		~Phaser();
+
+		SFM_INLINE void SetRate(float rate)
+		{
+			m_sweep.SetFrequency(rate);
+		}
+
+		// Advances sweep LFO whilst not applied
+		SFM_INLINE void SkipFreeRunning(uint64_t numSamples)
+		{
+			m_sweep.Skip(numSamples);
+		}
+
+		// Mixes phased signal on top of input (in place); samples at which 'wetness' is zero are skipped entirely
+		void Apply(float *pLeft, float *pRight, unsigned numSamples, InterpolatedParameter<kLinInterpolate, true> &wetness);
+
+	private:
+		// Sweeps cutoff & returns 'g' for next sample
+		float SampleG();
+
+		// Runs m_pL/m_pR (in place) through all stages, 'g' per sample in m_pG
+		void Cascade(unsigned numSamples);
+
+		const unsigned m_sampleRate;
+		const unsigned m_Nyquist;
+
+		Phase m_sweep;
+		SinglePoleLPF m_sweepLPF;
+
+		// Control rate 'g'
+		unsigned m_countdown = 0;
+		float m_g, m_deltaG = 0.f;
+
+		// 'k' and all-pass mix (-2k) per stage (kept in lane order, see Cascade())
+		alignas(16) float m_k[kNumPhaserStages*2];
+		alignas(16) float m_m1[kNumPhaserStages*2];
+
+		// State per stage & channel (L, R)
+		alignas(16) float m_ic1eq[kNumPhaserStages*2];
+		alignas(16) float m_ic2eq[kNumPhaserStages*2];
+
+		// Gathered (wet) samples
+		float *m_pL = nullptr;
+		float *m_pR = nullptr;
+		float *m_pG = nullptr;
+		float *m_pWet = nullptr;
+		unsigned *m_pIndex = nullptr;
+	};
+}
@@ -0,0 +1,277 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Vectorized (SSE2) kernel for the oversampled part of the post pass.
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include "synth-post-kernel.h"
+
+namespace SFM
+{
+	/* ----------------------------------------------------------------------------------------------------
+
+		ZoelzerClip(): sign(x)*(1-e^-|x|)
+
+		e^x for x <= 0 is Cephes' expf() (relative error about 1E-7) minus it's special cases; both paths
+		perform the exact same operations
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	constexpr float kExpMin     = -87.f; // Keeps 2^n normal
+	constexpr float kExpLog2e   = 1.44269504088896341f;
+	constexpr float kExpC1      = 0.693359375f;
+	constexpr float kExpC2      = -2.12194440e-4f;
+	constexpr float kExpP0      = 1.9875691500E-4f;
+	constexpr float kExpP1      = 1.3981999507E-3f;
+	constexpr float kExpP2      = 8.3334519073E-3f;
+	constexpr float kExpP3      = 4.1665795894E-2f;
+	constexpr float kExpP4      = 1.6666665459E-1f;
+	constexpr float kExpP5      = 5.0000001201E-1f;
+
+	SFM_INLINE static float ZoelzerClipApprox(float sample)
+	{
+		float x = std::max<float>(-fabsf(sample), kExpMin);
+
+		// Split in 2^n & remainder
+		const float fx = x*kExpLog2e + 0.5f;
+		float n = float(int(fx));
+		if (n > fx)
+			n -= 1.f;
+
+		x = x - n*kExpC1;
+		x = x - n*kExpC2;
+
+		const float z = x*x;
+		float y = kExpP0;
+		y = y*x + kExpP1;
+		y = y*x + kExpP2;
+		y = y*x + kExpP3;
+		y = y*x + kExpP4;
+		y = y*x + kExpP5;
+		y = y*z + x + 1.f;
+
+		const int32_t pow2n = (int32_t(n) + 127) << 23;
+		float scale;
+		memcpy(&scale, &pow2n, sizeof(float));
+
+		return copysignf(1.f - y*scale, sample);
+	}
+
+#if defined(SFM_SIMD_POST)
+
+	SFM_INLINE static __m128 ZoelzerClipLanes(__m128 sample)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.f);
+		const __m128 sign = _mm_and_ps(signMask, sample);
+
+		__m128 x = _mm_max_ps(_mm_or_ps(signMask, sample) /* -|x| */, _mm_set1_ps(kExpMin));
+
+		// Split in 2^n & remainder
+		const __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(kExpLog2e)), _mm_set1_ps(0.5f));
+		__m128 n = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+		n = _mm_sub_ps(n, _mm_and_ps(_mm_cmpgt_ps(n, fx), _mm_set1_ps(1.f)));
+
+		x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(kExpC1)));
+		x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(kExpC2)));
+
+		const __m128 z = _mm_mul_ps(x, x);
+		__m128 y = _mm_set1_ps(kExpP0);
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP1));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP2));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP3));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP4));
+		y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP5));
+		y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), _mm_set1_ps(1.f));
+
+		const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23));
+
+		// Copy sign
+		return _mm_or_ps(_mm_andnot_ps(signMask, _mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(y, scale))), sign);
+	}
+
+	void ZoelzerClipBlock(float *pSamples, unsigned numSamples)
+	{
+		SFM_ASSERT(nullptr != pSamples);
+
+		unsigned iSample = 0;
+		for (; iSample+4 <= numSamples; iSample += 4)
+			_mm_storeu_ps(pSamples+iSample, ZoelzerClipLanes(_mm_loadu_ps(pSamples+iSample)));
+
+		for (; iSample < numSamples; ++iSample)
+			pSamples[iSample] = ZoelzerClipApprox(pSamples[iSample]);
+	}
+
+#else
+
+	void ZoelzerClipBlock(float *pSamples, unsigned numSamples)
+	{
+		SFM_ASSERT(nullptr != pSamples);
+
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			pSamples[iSample] = ZoelzerClipApprox(pSamples[iSample]);
+	}
+
+#endif
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		PostLadder
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	void PostLadder::Reset()
+	{
+		for (unsigned iStage = 0; iStage < 4; ++iStage)
+		{
+			for (unsigned iLane = 0; iLane < 4; ++iLane)
+				m_stage[iStage][iLane] = m_delay[iStage][iLane] = 0.f;
+		}
+
+		m_isFirst = true;
+	}
+
+	void PostLadder::SetParameters(float cutoffHz, float resonance)
+	{
+		SFM_ASSERT(resonance >= 0.f && resonance <= 1.f);
+
+		if (false == m_isFirst && cutoffHz == m_cutoffHz && resonance == m_resonance)
+			return;
+
+		m_cutoffHz = cutoffHz;
+		m_resonance = resonance;
+
+		// See MusicDSPMoog::SetCutoff() & SetResonance()
+		const float cutoff = 2.f * cutoffHz/m_sampleRate;
+
+		m_targetP = cutoff * (1.8f - 0.8f * cutoff);
+		m_targetK = 2.f * sinf(cutoff*kPI*0.5f) - 1.f;
+
+		const float t1 = (1.f - m_targetP) * 1.386249f;
+		const float t2 = 12.f + t1*t1;
+		m_targetFeedback = resonance * (t2 + 6.f*t1) / (t2 - 6.f*t1);
+
+		if (true == m_isFirst)
+		{
+			m_p = m_targetP;
+			m_k = m_targetK;
+			m_feedback = m_targetFeedback;
+
+			m_isFirst = false;
+		}
+	}
+
+#if defined(SFM_SIMD_POST)
+
+	void PostLadder::Apply(float *pLeft, float *pRight, unsigned numSamples)
+	{
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
+		SFM_ASSERT(false == m_isFirst);
+
+		if (0 == numSamples)
+			return;
+
+		const float deltaP = (m_targetP-m_p)/numSamples;
+		const float deltaK = (m_targetK-m_k)/numSamples;
+		const float deltaFeedback = (m_targetFeedback-m_feedback)/numSamples;
+
+		__m128 stage0 = _mm_load_ps(m_stage[0]), stage1 = _mm_load_ps(m_stage[1]), stage2 = _mm_load_ps(m_stage[2]), stage3 = _mm_load_ps(m_stage[3]);
+		__m128 delay0 = _mm_load_ps(m_delay[0]), delay1 = _mm_load_ps(m_delay[1]), delay2 = _mm_load_ps(m_delay[2]), delay3 = _mm_load_ps(m_delay[3]);
+
+		const __m128 six = _mm_set1_ps(6.f);
+
+		float p = m_p, k = m_k, feedback = m_feedback;
+
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			p += deltaP;
+			k += deltaK;
+			feedback += deltaFeedback;
+
+			const __m128 P = _mm_set1_ps(p);
+			const __m128 K = _mm_set1_ps(k);
+
+			const __m128 x = _mm_sub_ps(_mm_unpacklo_ps(_mm_load_ss(pLeft+iSample), _mm_load_ss(pRight+iSample)), _mm_mul_ps(_mm_set1_ps(feedback), stage3));
+
+			// Four cascaded one-pole filters (bilinear transform)
+			stage0 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, P),      _mm_mul_ps(delay0, P)), _mm_mul_ps(K, stage0));
+			stage1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(stage0, P), _mm_mul_ps(delay1, P)), _mm_mul_ps(K, stage1));
+			stage2 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(stage1, P), _mm_mul_ps(delay2, P)), _mm_mul_ps(K, stage2));
+			stage3 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(stage2, P), _mm_mul_ps(delay3, P)), _mm_mul_ps(K, stage3));
+
+			// Clipping band-limited sigmoid
+			stage3 = _mm_sub_ps(stage3, _mm_div_ps(_mm_mul_ps(_mm_mul_ps(stage3, stage3), stage3), six));
+
+			delay0 = x;
+			delay1 = stage0;
+			delay2 = stage1;
+			delay3 = stage2;
+
+			_mm_store_ss(pLeft+iSample, stage3);
+			_mm_store_ss(pRight+iSample, _mm_shuffle_ps(stage3, stage3, _MM_SHUFFLE(1, 1, 1, 1)));
+		}
+
+		_mm_store_ps(m_stage[0], stage0); _mm_store_ps(m_stage[1], stage1); _mm_store_ps(m_stage[2], stage2); _mm_store_ps(m_stage[3], stage3);
+		_mm_store_ps(m_delay[0], delay0); _mm_store_ps(m_delay[1], delay1); _mm_store_ps(m_delay[2], delay2); _mm_store_ps(m_delay[3], delay3);
+
+		m_p = m_targetP;
+		m_k = m_targetK;
+		m_feedback = m_targetFeedback;
+	}
+
+#else
+
+	void PostLadder::Apply(float *pLeft, float *pRight, unsigned numSamples)
+	{
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
+		SFM_ASSERT(false == m_isFirst);
+
+		if (0 == numSamples)
+			return;
+
+		const float deltaP = (m_targetP-m_p)/numSamples;
+		const float deltaK = (m_targetK-m_k)/numSamples;
+		const float deltaFeedback = (m_targetFeedback-m_feedback)/numSamples;
+
+		float p = m_p, k = m_k, feedback = m_feedback;
+
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			p += deltaP;
+			k += deltaK;
+			feedback += deltaFeedback;
+
+			float *pSamples[2] = { pLeft+iSample, pRight+iSample };
+
+			for (unsigned iLane = 0; iLane < 2; ++iLane)
+			{
+				float &stage0 = m_stage[0][iLane], &stage1 = m_stage[1][iLane], &stage2 = m_stage[2][iLane], &stage3 = m_stage[3][iLane];
+				float &delay0 = m_delay[0][iLane], &delay1 = m_delay[1][iLane], &delay2 = m_delay[2][iLane], &delay3 = m_delay[3][iLane];
+
+				const float x = *pSamples[iLane] - feedback*stage3;
+
+				// Four cascaded one-pole filters (bilinear transform)
+				stage0 = x*p + delay0*p - k*stage0;
+				stage1 = stage0*p + delay1*p - k*stage1;
+				stage2 = stage1*p + delay2*p - k*stage2;
+				stage3 = stage2*p + delay3*p - k*stage3;
+
+				// Clipping band-limited sigmoid
+				stage3 -= (stage3*stage3*stage3)/6.f;
+
+				delay0 = x;
+				delay1 = stage0;
+				delay2 = stage1;
+				delay3 = stage2;
+
+				*pSamples[iLane] = stage3;
+			}
+		}
+
+		m_p = m_targetP;
+		m_k = m_targetK;
+		m_feedback = m_targetFeedback;
+	}
+
+#endif
+}
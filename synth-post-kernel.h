@@ -0,0 +1,70 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Vectorized (SSE2) kernel for the oversampled part of the post pass.
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	PostPass::ApplyOversampled() processes the oversampled block in chunks of kPostControlRate samples; parameters
+	are advanced per chunk and interpolated in between, which leaves the heavy lifting to:
+
+	- ZoelzerClipBlock(): same curve as ZoelzerClip() (synth-distort.h) but it doesn't depend on the previous sample,
+	  so it's vectorized across samples; expf() is replaced by a polynomial approximation (Cephes) to do so
+	- PostLadder: MusicDSPMoog (3rdparty/filters/MusicDSPModel.h) for a block of already driven & clipped samples,
+	  left & right in SSE lanes; the coefficients (sinf() plus resonance math) are only calculated if cutoff or
+	  resonance changed, and linearly interpolated over the block
+
+	Results are bit-identical to the scalar path, so they can be A/B'd (define SFM_DISABLE_SIMD_POST).
+*/
+
+#pragma once
+
+#include "synth-global.h"
+
+#if !defined(SFM_DISABLE_SIMD_POST) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define SFM_SIMD_POST
+	#include <emmintrin.h>
+#endif
+
+namespace SFM
+{
+	// Oversampled samples per parameter update
+	constexpr unsigned kPostControlRate = 16;
+
+	// ZoelzerClip() for 'numSamples' samples (in place)
+	void ZoelzerClipBlock(float *pSamples, unsigned numSamples);
+
+	class PostLadder
+	{
+	public:
+		PostLadder(unsigned sampleRate) :
+			m_sampleRate(sampleRate)
+		{
+			Reset();
+		}
+
+		~PostLadder() {}
+
+		// After Reset() the first SetParameters() is taken as is
+		void Reset();
+
+		// Parameters to reach at the end of the next Apply()
+		void SetParameters(float cutoffHz, float resonance /* [0..1] */);
+
+		// Samples must be driven & clipped (see ZoelzerClipBlock())
+		void Apply(float *pLeft, float *pRight, unsigned numSamples);
+
+	private:
+		const unsigned m_sampleRate;
+
+		float m_cutoffHz = 0.f, m_resonance = 0.f;
+		bool m_isFirst;
+
+		// Coefficients (current & target)
+		float m_p, m_k, m_feedback;
+		float m_targetP, m_targetK, m_targetFeedback;
+
+		// State per stage, lanes: L, R (& 2 unused)
+		alignas(16) float m_stage[4][4];
+		alignas(16) float m_delay[4][4];
+	};
+}
@@ -8,8 +8,8 @@
 	- Auto-wah/Vox
 	- Yamaha Reface CP-style chorus & phaser
 	- Delay
-	- Tube distortion (4X oversampling)
-	- Post filter (24dB) (4X oversampling)
+	- Tube distortion (oversampled, 4X by default)
+	- Post filter (24dB) (oversampled, 4X by default)
 	- Reverb
 	- Compressor
 	- Low cut, 3-band tuning, master volume & final clamp
@@ -19,6 +19,7 @@
 */
 
 #include "synth-post-pass.h"
+#include "synth-level-detect.h"
 #include "synth-stateless-oscillators.h"
 #include "synth-distort.h"
 #include "patch/synth-patch-global.h"
@@ -46,8 +47,18 @@ namespace SFM
 	constexpr float kTubeToneFlatQ = 0.f;
 	constexpr float kTubeToneColorQ = kGoldenRatio*0.0628f;
 
-	PostPass::PostPass(unsigned sampleRate, unsigned maxSamplesPerBlock, unsigned Nyquist) :
-		m_sampleRate(sampleRate), m_Nyquist(Nyquist), m_sampleRate4X(sampleRate*4)
+	// Power of 2 so that DelayLine::ReadNearest() wraps around seamlessly
+	static size_t GetBypassLineSize(unsigned delay)
+	{
+		size_t size = 1;
+		while (size <= delay)
+			size <<= 1;
+
+		return size;
+	}
+
+	PostPass::PostPass(unsigned sampleRate, unsigned maxSamplesPerBlock, unsigned Nyquist, unsigned oversamplingStages, Oversampler::Design oversamplingDesign) :
+		m_sampleRate(sampleRate), m_Nyquist(Nyquist), m_sampleRateOS(sampleRate<<oversamplingStages)
 
 		// Delay
 ,		m_tapeDelayLFO(sampleRate)
@@ -61,29 +72,33 @@ namespace SFM
 ,		m_curDelayFeedback(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,		m_curDelayFeedbackCutoff(1.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,		m_curDelayTapeWow(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
+,		m_delayTail(unsigned(sampleRate*kMainDelayLineSize))
 		
 		// Chorus/Phaser
 ,		m_chorusDL(sampleRate/10  /* 100MS max. chorus delay */)
 ,		m_chorusSweep(sampleRate), m_chorusSweepMod(sampleRate)
 ,		m_chorusSweepLPF1(kSweepCutoffHz/sampleRate), m_chorusSweepLPF2(kSweepCutoffHz/sampleRate)
-,		m_phaserSweep(sampleRate)
-,		m_phaserSweepLPF((kSweepCutoffHz*2.f)/sampleRate) // Tweaked a little for effect
+,		m_phaser(sampleRate, Nyquist, maxSamplesPerBlock)
 
 		// Oversampling (stereo)
-,		m_oversampling4X(2, 2, juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true)
+,		m_oversampler(oversamplingStages, oversamplingDesign, maxSamplesPerBlock)
+,		m_oversamplingBypassDelay(unsigned(m_oversampler.GetLatency() + 0.5f))
+,		m_oversamplingBypassL(GetBypassLineSize(m_oversamplingBypassDelay))
+,		m_oversamplingBypassR(GetBypassLineSize(m_oversamplingBypassDelay))
+,		m_curOversamplingMix(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 
 		// Post filter
-,		m_postFilter(m_sampleRate4X)
-,		m_curPostCutoff(0.f, m_sampleRate4X, kDefParameterLatency * 2.f /* Longer */, 0.f, 1.f)
-,		m_curPostReso(0.f, m_sampleRate4X, kDefParameterLatency, 0.f, 1.f)
-,		m_curPostDrive(0.f, m_sampleRate4X, kDefParameterLatency, 0.f, 1.f)
-,		m_curPostWet(0.f, m_sampleRate4X, kDefParameterLatency, 0.f, 1.f)
+,		m_postFilter(m_sampleRateOS)
+,		m_curPostCutoff(0.f, m_sampleRateOS, kDefParameterLatency * 2.f /* Longer */, 0.f, 1.f)
+,		m_curPostReso(0.f, m_sampleRateOS, kDefParameterLatency, 0.f, 1.f)
+,		m_curPostDrive(0.f, m_sampleRateOS, kDefParameterLatency, 0.f, 1.f)
+,		m_curPostWet(0.f, m_sampleRateOS, kDefParameterLatency, 0.f, 1.f)
 		
 		// Tube distort
-,		m_curTubeDist(0.f, m_sampleRate4X, kDefParameterLatency, 0.f, 1.f)
-,		m_curTubeDrive(kDefTubeDrive, m_sampleRate4X, kDefParameterLatency, 0.f, 1.f)
-,		m_curTubeOffset(0.f, m_sampleRate4X, kDefParameterLatency, 0.f, 1.f)
-,		m_curTubeTone(kDefTubeTone, m_sampleRate4X, kDefParameterLatency, 0.f, 1.f)
+,		m_curTubeDist(0.f, m_sampleRateOS, kDefParameterLatency, 0.f, 1.f)
+,		m_curTubeDrive(kDefTubeDrive, m_sampleRateOS, kDefParameterLatency, 0.f, 1.f)
+,		m_curTubeOffset(0.f, m_sampleRateOS, kDefParameterLatency, 0.f, 1.f)
+,		m_curTubeTone(kDefTubeTone, m_sampleRateOS, kDefParameterLatency, 0.f, 1.f)
 
 		// Post (EQ)
 ,		m_postEQ(sampleRate, true)
@@ -98,13 +113,13 @@ namespace SFM
 ,		m_curChorusWet(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,		m_curPhaserWet(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,		m_curMasterVol(1.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
+,		m_silence(sampleRate/10 /* Chorus */ + m_oversampler.GetSettleTime() + unsigned(sampleRate*kCompLookaheadMS*0.001f))
 	{
 		// Allocate intermediate buffers
 		m_pBufL  = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
 		m_pBufR  = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
-
-		// Initialize JUCE oversampling object (FIXME)
-		m_oversampling4X.initProcessing(maxSamplesPerBlock);
+		m_pBypassL = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
+		m_pBypassR = reinterpret_cast<float *>(mallocAligned(maxSamplesPerBlock*sizeof(float), 16));
 
 		// Set tape delay mod. frequency
 		m_tapeDelayLFO.Initialize(kTapeDelayHz, m_sampleRate);
@@ -118,12 +133,14 @@ namespace SFM
 	{
 		freeAligned(m_pBufL);
 		freeAligned(m_pBufR);
+		freeAligned(m_pBypassL);
+		freeAligned(m_pBypassR);
 	}
 
 	float PostPass::GetLatency() const
 	{
 		// FIXME: approx. complete sum best possible
-		const float oversamplingLatency = m_oversampling4X.getLatencyInSamples();
+		const float oversamplingLatency = m_oversampler.GetLatency();
 		const float compressorLatency   = m_compressor.GetLatency();
 
 		return oversamplingLatency + compressorLatency;
@@ -201,6 +218,10 @@ namespace SFM
 
 			Mixed on top of original signal, does not introduce latency.
 
+			The delay is bypassed if it's wet is (settled at) zero, in which case it's tail is dropped, or if both
+			it's input and tail are silent, which is when it's delay lines are (close to) empty. Chorus and phaser
+			are skipped whilst their wet is zero.
+
 		 ------------------------------------------------------------------------------------------------------ */
 
 		if (true == isChorus)
@@ -240,115 +261,165 @@ namespace SFM
 			SetChorusRate(rateBPM, kMaxChorusRate/kMaxPhaserRate);
 			SetPhaserRate(rateBPM, 1.f);
 		}
-				
-		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
-		{
-			const float sampleL = m_pBufL[iSample];
-			const float sampleR = m_pBufR[iSample];
 
-			float left = sampleL, right = sampleR;
-				
-			// Always feed the chorus delay line
-			// This approach has it's flaws: https://matthewvaneerde.wordpress.com/2010/12/07/downmixing-stereo-to-mono/
-			m_chorusDL.Write(left*0.5f + right*0.5f);
-			
-			//
-			// Apply chorus & phaser
-			//
+		const bool isChorusPhaserMuted = true == m_curChorusWet.IsDone() && 0.f == m_curChorusWet.Get() &&
+		                                 true == m_curPhaserWet.IsDone() && 0.f == m_curPhaserWet.Get();
 
-			const float chorusWet = m_curChorusWet.Sample();
-			const float phaserWet = m_curPhaserWet.Sample();
+		// Delay input is only known up front if chorus & phaser are muted
+		const bool isDelayMuted = true == m_curDelayWet.IsDone() && 0.f == m_curDelayWet.Get();
+		const bool isDelayBypassed = true == isDelayMuted ||
+		                             (true == isChorusPhaserMuted && true == m_delayTail.IsSilent() && GetRectifiedMaximum(m_pBufL, m_pBufR, numSamples) <= kInfLin);
 
-			// Breaking my own 'execute the entire chain' rule here
-			if (chorusWet > 0.f) 
-				ApplyChorus(sampleL, sampleR, left, right, chorusWet);
-			
-			if (phaserWet > 0.f)
-				ApplyPhaser(left, right, left, right, phaserWet);
+		if (true == isDelayBypassed)
+		{
+			// The tail is inaudible whilst muted; drop it so it won't resurface when wet goes up again
+			if (false == m_delayTail.IsSilent())
+			{
+				m_delayLineL.Reset();
+				m_delayLineM.Reset();
+				m_delayLineR.Reset();
+				m_delayFeedbackLPF_L.Reset(0.f);
+				m_delayFeedbackLPF_R.Reset(0.f);
+				m_delayTail.Reset();
+			}
+
+			// Keep parameters in pace
+			m_curDelayInSec.Skip(numSamples);
+			m_curDelayWet.Skip(numSamples);
+			m_curDelayDrive.Skip(numSamples);
+			m_curDelayFeedback.Skip(numSamples);
+			m_curDelayFeedbackCutoff.Skip(numSamples);
+			m_curDelayTapeWow.Skip(numSamples);
+		}
+
+		float delayInputPeak = 0.f, delayTailPeak = 0.f;
+
+		if (true == isDelayBypassed && true == isChorusPhaserMuted)
+		{
+			// Only feed the chorus delay line (see below)
+			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+				m_chorusDL.Write(m_pBufL[iSample]*0.5f + m_pBufR[iSample]*0.5f);
+		}
+		else
+		{
+			// Apply chorus
+			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			{
+				const float sampleL = m_pBufL[iSample];
+				const float sampleR = m_pBufR[iSample];
+				
+				// Always feed the chorus delay line
+				// This approach has it's flaws: https://matthewvaneerde.wordpress.com/2010/12/07/downmixing-stereo-to-mono/
+				m_chorusDL.Write(sampleL*0.5f + sampleR*0.5f);
 
-			//
-			// Apply delay (always executed, for now, FIXME?)
-			//
+				const float chorusWet = m_curChorusWet.Sample();
 
-			const float monaural = left*0.5f + right*0.5f;
+				// Breaking my own 'execute the entire chain' rule here
+				if (chorusWet > 0.f) 
+					ApplyChorus(sampleL, sampleR, m_pBufL[iSample], m_pBufR[iSample], chorusWet);
+			}
 
-			const float curDelayInSec = m_curDelayInSec.Sample();
-			SFM_ASSERT(curDelayInSec >= 0.f && curDelayInSec <= kMainDelayInSec);
+			// Apply phaser (entire block at once, see synth-phaser.h)
+			m_phaser.Apply(m_pBufL, m_pBufR, numSamples, m_curPhaserWet);
+		}
 
-			// Write driven samples to delay line
-			const float drive = m_curDelayDrive.Sample();
-			m_delayLineL.Write(left     * drive);
-			m_delayLineM.Write(monaural * drive);
-			m_delayLineR.Write(right    * drive);
+		if (false == isDelayBypassed)
+		{
+			// Apply delay
+			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			{
+				const float left  = m_pBufL[iSample];
+				const float right = m_pBufR[iSample];
+
+				const float monaural = left*0.5f + right*0.5f;
+
+				const float curDelayInSec = m_curDelayInSec.Sample();
+				SFM_ASSERT(curDelayInSec >= 0.f && curDelayInSec <= kMainDelayInSec);
+
+				// Write driven samples to delay line
+				const float drive = m_curDelayDrive.Sample();
+				m_delayLineL.Write(left     * drive);
+				m_delayLineM.Write(monaural * drive);
+				m_delayLineR.Write(right    * drive);
 			
-			// Sample delay line
-			const float curDelay   = curDelayInSec/kMainDelayInSec;
-			const float curTapeWow = m_curDelayTapeWow.Sample();
-			const float normDelay  = curDelay + curTapeWow*(curDelay*curDelay)*kTapeDelaySpread*m_tapeDelayLPF.Apply(fast_cosf(m_tapeDelayLFO.Sample()));
-			const float delayedL   = m_delayLineL.ReadNormalized(normDelay);
-			const float delayedM   = m_delayLineM.ReadNormalized(normDelay);
-			const float delayedR   = m_delayLineR.ReadNormalized(normDelay);
+				// Sample delay line
+				const float curDelay   = curDelayInSec/kMainDelayInSec;
+				const float curTapeWow = m_curDelayTapeWow.Sample();
+				const float normDelay  = curDelay + curTapeWow*(curDelay*curDelay)*kTapeDelaySpread*m_tapeDelayLPF.Apply(fast_cosf(m_tapeDelayLFO.Sample()));
+				const float delayedL   = m_delayLineL.ReadNormalized(normDelay);
+				const float delayedM   = m_delayLineM.ReadNormalized(normDelay);
+				const float delayedR   = m_delayLineR.ReadNormalized(normDelay);
 			
-			// Bleed delay samples a bit
-			constexpr float crossBleedAmt = kDelayCrossbleeding;
-			constexpr float invCrossBleedAmt = 1.f-crossBleedAmt;
-			const float crossBleed = delayedM;
-			const float delayL = delayedL*invCrossBleedAmt + crossBleed*crossBleedAmt;
-			const float delayR = delayedR*invCrossBleedAmt + crossBleed*crossBleedAmt;
-
-			// Filter delay
-			const float curFc = (m_curDelayFeedbackCutoff.Sample() * m_Nyquist/4)/m_sampleRate; // Limited range gives a more pronounced effect
-			m_delayFeedbackLPF_L.SetCutoff(curFc);
-			m_delayFeedbackLPF_R.SetCutoff(curFc);
-
-			const float filteredL = m_delayFeedbackLPF_L.Apply(delayL);
-			const float filteredR = m_delayFeedbackLPF_R.Apply(delayR);
-
-			const float filteredM = 0.5f*filteredL + 0.5f*filteredR;
-
-			// Feedback
-			const float curFeedback =  m_curDelayFeedback.Sample()*kMaxDelayFeedback;
-			m_delayLineL.WriteFeedback(filteredL, curFeedback);
-			m_delayLineM.WriteFeedback(filteredM, curFeedback);
-			m_delayLineR.WriteFeedback(filteredR, curFeedback);
-
-			// Add delay
-
-//			const float wet = m_curDelayWet.Sample();
-//			m_pBufL[iSample] = left  + wet*delayL;
-//			m_pBufR[iSample] = right + wet*delayR;
-
-			// Stereo (width) effect (fixed)
-			// Nicked from synth-reverb.cpp
-			const float wet = m_curDelayWet.Sample();
-			const float dry = 1.f-wet;
-
-			const float width = kGoldenRatio; // FIXME: parameter?
-			const float wet1  = wet*(width*0.5f + 0.5f);
-			const float wet2  = wet*((1.f-width)*0.5f);
+				// Bleed delay samples a bit
+				constexpr float crossBleedAmt = kDelayCrossbleeding;
+				constexpr float invCrossBleedAmt = 1.f-crossBleedAmt;
+				const float crossBleed = delayedM;
+				const float delayL = delayedL*invCrossBleedAmt + crossBleed*crossBleedAmt;
+				const float delayR = delayedR*invCrossBleedAmt + crossBleed*crossBleedAmt;
+
+				// Filter delay
+				const float curFc = (m_curDelayFeedbackCutoff.Sample() * m_Nyquist/4)/m_sampleRate; // Limited range gives a more pronounced effect
+				m_delayFeedbackLPF_L.SetCutoff(curFc);
+				m_delayFeedbackLPF_R.SetCutoff(curFc);
+
+				const float filteredL = m_delayFeedbackLPF_L.Apply(delayL);
+				const float filteredR = m_delayFeedbackLPF_R.Apply(delayR);
+
+				const float filteredM = 0.5f*filteredL + 0.5f*filteredR;
+
+				// Feedback
+				const float curFeedback =  m_curDelayFeedback.Sample()*kMaxDelayFeedback;
+				m_delayLineL.WriteFeedback(filteredL, curFeedback);
+				m_delayLineM.WriteFeedback(filteredM, curFeedback);
+				m_delayLineR.WriteFeedback(filteredR, curFeedback);
+
+				// Add delay
+
+//				const float wet = m_curDelayWet.Sample();
+//				m_pBufL[iSample] = left  + wet*delayL;
+//				m_pBufR[iSample] = right + wet*delayR;
+
+				// Stereo (width) effect (fixed)
+				// Nicked from synth-reverb.cpp
+				const float wet = m_curDelayWet.Sample();
+				const float dry = 1.f-wet;
+
+				const float width = kGoldenRatio; // FIXME: parameter?
+				const float wet1  = wet*(width*0.5f + 0.5f);
+				const float wet2  = wet*((1.f-width)*0.5f);
 			
-//			m_pBufL[iSample] = delayL*wet1 + delayR*wet2 + left*dry;
-//			m_pBufR[iSample] = delayR*wet1 + delayL*wet2 + right*dry;
+//				m_pBufL[iSample] = delayL*wet1 + delayR*wet2 + left*dry;
+//				m_pBufR[iSample] = delayR*wet1 + delayL*wet2 + right*dry;
 			
-			// To be more like Ableton, we'll use the filtered samples rightaway
-			m_pBufL[iSample] = filteredL*wet1 + filteredR*wet2 + left*dry;
-			m_pBufR[iSample] = filteredR*wet1 + filteredL*wet2 + right*dry;
+				// To be more like Ableton, we'll use the filtered samples rightaway
+				m_pBufL[iSample] = filteredL*wet1 + filteredR*wet2 + left*dry;
+				m_pBufR[iSample] = filteredR*wet1 + filteredL*wet2 + right*dry;
+
+				delayInputPeak = std::max<float>(delayInputPeak, GetRectifiedMaximum(left, right));
+				delayTailPeak  = std::max<float>(delayTailPeak,  GetRectifiedMaximum(filteredL, filteredR));
+			}
 		}
 
+		if (false == isDelayBypassed)
+			m_delayTail.Run(delayInputPeak, delayTailPeak, numSamples);
+
 		/* ----------------------------------------------------------------------------------------------------
 
-			Oversampled: 24dB ladder filter & tube distortion (4X)
+			Oversampled: 24dB ladder filter & tube distortion (4X by default, see Oversampler)
 
 			JUCE says:
 			" Choose between FIR or IIR filtering depending on your needs in term of latency and phase 
 			  distortion. With FIR filters, the phase is linear but the latency is maximised. With IIR 
 			  filtering, the phase is compromised around the Nyquist frequency but the latency is minimised. "
 		 
-		 	Currently using FIR (ergo low phase distortion over latency).
+		 	FIR by default (ergo low phase distortion over latency), the same goes for our own oversampler.
 		 
 		 	Not oversampling degrades the quality of the effects; the distortion is much more prone to coarse
 		 	transients and aliasing and the stability of the 24dB filter kernel is less.
 
+			If both distortion and filter are (settled at) zero the stage is bypassed by a pure delay of the same
+			latency, which it fades from and to (only after the oversampler has settled), so latency stays put.
+
 		 ------------------------------------------------------------------------------------------------------ */
                         
 		// Set post filter parameters
@@ -365,74 +436,78 @@ namespace SFM
 
 		const float toneQ = SVF_ResoToQ(tubeToneReso ? kTubeToneColorQ : kTubeToneFlatQ);
 		
-		// Main buffers
-		float *inputBuffers[2] = { m_pBufL, m_pBufR };
-		juce::dsp::AudioBlock<float> inputBlock(inputBuffers, 2, numSamples);
-
-		// Oversample 4X
-		auto outBlock = m_oversampling4X.processSamplesUp(inputBlock);
-		const size_t numOversamples = outBlock.getNumSamples();
-		SFM_ASSERT(numOversamples == numSamples*4);
-
-		float *pOverL = outBlock.getChannelPointer(0);
-		float *pOverR = outBlock.getChannelPointer(1);
+		// Pure delay of equal latency, to bypass (and fade to and from) the oversampled stage
+		const int bypassDelay = int(m_oversamplingBypassDelay);
 
-		for (unsigned iSample = 0; iSample < numOversamples; ++iSample)
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
 		{
-			float sampleL = pOverL[iSample]; 
-			float sampleR = pOverR[iSample];
-
-			// Apply (non-linear) distortion
-			const float amount = m_curTubeDist.Sample();
-			const float drive  = m_curTubeDrive.Sample();
-			const float offset = m_curTubeOffset.Sample();
-			const float tone   = m_curTubeTone.Sample();
-
-			// Apply (soft) clipping
-			float inDistSampleL = sampleL, inDistSampleR = sampleR;
-
-			// Apply tone filter (resonant LPF)
-			m_tubeToneFilter.updateLowpassCoeff(SVF_CutoffToHz(tone, m_Nyquist), toneQ, m_sampleRate4X);
-			m_tubeToneFilter.tick(inDistSampleL, inDistSampleR);
-
-//			const float driveAdj = drive/kMaxTubeDrive; // Normalized
-//			float distortedL = Squarepusher(offset+sampleL, driveAdj);
-//			float distortedR = Squarepusher(offset+sampleR, driveAdj);
-			float distortedL = ZoelzerClip((offset+inDistSampleL)*drive); // CubicClip(offset+sampleL, drive);
-			float distortedR = ZoelzerClip((offset+inDistSampleR)*drive); // CubicClip(offset+sampleR, drive);
-
-			// Remove possible DC offset
-			m_tubeDCBlocker.Apply(distortedL, distortedR);
-
-			// Add to signal
-//			float postDistortedL = sampleL + distortedL*amount; // lerpf<float>(sampleL, distortedL, smoothstepped);
-//			float postDistortedR = sampleR + distortedR*amount; // lerpf<float>(sampleR, distortedR, smoothstepped);
-//			const float smoothstepped = smoothstepf(amount);
-			float postDistortedL = lerpf<float>(sampleL, distortedL, amount);
-			float postDistortedR = lerpf<float>(sampleR, distortedR, amount);
-
-			// Apply 24dB post filter
-			const float curPostCutoff = m_curPostCutoff.Sample();
-			const float curPostReso   = m_curPostReso.Sample();
-			const float curPostDrive  = m_curPostDrive.Sample();
-			const float curPostWet    = m_curPostWet.Sample();
-
-			// Apply filter
-			float filteredL = postDistortedL, filteredR = postDistortedR;
-			m_postFilter.SetParameters(kMinPostFilterCutoffHz + curPostCutoff*kPostFilterCutoffRange, curPostReso /* [0..1] */, curPostDrive);
-			m_postFilter.Apply(filteredL, filteredR);
+			m_oversamplingBypassL.Write(m_pBufL[iSample]);
+			m_oversamplingBypassR.Write(m_pBufR[iSample]);
+			m_pBypassL[iSample] = m_oversamplingBypassL.ReadNearest(bypassDelay);
+			m_pBypassR[iSample] = m_oversamplingBypassR.ReadNearest(bypassDelay);
+		}
 
-			// Blend
-			sampleL = lerpf<float>(postDistortedL, filteredL, curPostWet);
-			sampleR = lerpf<float>(postDistortedR, filteredR, curPostWet);
+		// With both distortion & filter settled at zero the stage does nothing but add latency (see ApplyOversampled())
+		const bool isInert = true == m_curTubeDist.IsDone() && 0.f == m_curTubeDist.Get() &&
+		                     true == m_curPostWet.IsDone()  && 0.f == m_curPostWet.Get();
 
-			// Write
-			pOverL[iSample] = sampleL;
-			pOverR[iSample] = sampleR;
+		if (false == isInert && false == m_oversampling)
+		{
+			// Start from scratch and fade in once the filters have settled
+			m_oversampler.Reset();
+			m_tubeToneFilter.Reset();
+			m_tubeDCBlocker = StereoDCBlocker();
+			m_postFilter.Reset();
+
+			m_oversamplingWarmUp = m_oversampler.GetSettleTime();
+			m_oversampling = true;
 		}
 
-		// Downsample result
-		m_oversampling4X.processSamplesDown(inputBlock);
+		if (true == m_oversampling)
+		{
+			ApplyOversampled(numSamples, toneQ);
+
+			m_curOversamplingMix.SetTarget((true == isInert) ? 0.f : 1.f);
+
+			if (0 != m_oversamplingWarmUp || false == m_curOversamplingMix.IsDone() || 1.f != m_curOversamplingMix.Get())
+			{
+				for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+				{
+					float mix;
+					if (0 != m_oversamplingWarmUp)
+					{
+						--m_oversamplingWarmUp;
+						mix = m_curOversamplingMix.Get();
+					}
+					else
+						mix = m_curOversamplingMix.Sample();
+
+					m_pBufL[iSample] = lerpf<float>(m_pBypassL[iSample], m_pBufL[iSample], mix);
+					m_pBufR[iSample] = lerpf<float>(m_pBypassR[iSample], m_pBufR[iSample], mix);
+				}
+			}
+
+			// Faded out?
+			if (true == isInert && true == m_curOversamplingMix.IsDone() && 0.f == m_curOversamplingMix.Get())
+				m_oversampling = false;
+		}
+		else
+		{
+			// Bypass, but keep parameters in pace
+			const unsigned numOversamples = numSamples*m_oversampler.GetFactor();
+
+			m_curTubeDist.Skip(numOversamples);
+			m_curTubeDrive.Skip(numOversamples);
+			m_curTubeOffset.Skip(numOversamples);
+			m_curTubeTone.Skip(numOversamples);
+			m_curPostCutoff.Skip(numOversamples);
+			m_curPostReso.Skip(numOversamples);
+			m_curPostDrive.Skip(numOversamples);
+			m_curPostWet.Skip(numOversamples);
+
+			memcpy(m_pBufL, m_pBypassL, numSamples*sizeof(float));
+			memcpy(m_pBufR, m_pBypassR, numSamples*sizeof(float));
+		}
 
 		/* ----------------------------------------------------------------------------------------------------
 
@@ -472,17 +547,15 @@ namespace SFM
 		// Set master volume target
 		m_curMasterVol.SetTarget(dBToGain(masterVoldB));
 
-		// Set EQ target
+		// Set EQ target & apply
 		m_postEQ.SetTargetdBs(bassTuningdB, trebleTuningdB, midTuningdB);
+		m_postEQ.Process(m_pBufL, m_pBufR, numSamples);
 
 		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
 		{
 			float sampleL = m_pBufL[iSample];
 			float sampleR = m_pBufR[iSample];
 
-			// EQ
-			m_postEQ.Apply(sampleL, sampleR);
-
 			// Apply gain (master volume)
 			const float gain = m_curMasterVol.Sample();
 			sampleL *= gain;
@@ -495,13 +568,123 @@ namespace SFM
 			pLeftOut[iSample]  = Clamp(sampleL);
 			pRightOut[iSample] = Clamp(sampleR);
 		}
+
+		m_silence.Run(GetRectifiedMaximum(pLeftIn, pRightIn, numSamples), GetRectifiedMaximum(pLeftOut, pRightOut, numSamples), numSamples);
+	}
+
+	// Tube distortion & post filter, oversampled (in place, m_pBufL & m_pBufR)
+	// Advances parameter by 'numSamples', returns it's current value and (in 'step') the step per sample to get there
+	template<typename T> SFM_INLINE static float AdvanceParameter(T &parameter, unsigned numSamples, float &step)
+	{
+		const float value = parameter.Get();
+		parameter.Skip(numSamples);
+		step = (parameter.Get()-value)/numSamples;
+
+		return value;
+	}
+
+	void PostPass::ApplyOversampled(unsigned numSamples, float toneQ)
+	{
+		// Oversample
+		const unsigned numOversamples = m_oversampler.Upsample(m_pBufL, m_pBufR, numSamples);
+		SFM_ASSERT(numOversamples == numSamples*m_oversampler.GetFactor());
+
+		float *pOverL = m_oversampler.GetLeft();
+		float *pOverR = m_oversampler.GetRight();
+
+		// Processed in chunks of kPostControlRate samples; parameters are advanced per chunk and linearly
+		// interpolated in between (see synth-post-kernel.h)
+		alignas(16) float distortedL[kPostControlRate], distortedR[kPostControlRate];
+		alignas(16) float filteredL[kPostControlRate],  filteredR[kPostControlRate];
+
+		for (unsigned iChunk = 0; iChunk < numOversamples; iChunk += kPostControlRate)
+		{
+			const unsigned numChunkSamples = std::min<unsigned>(kPostControlRate, numOversamples-iChunk);
+
+			float *pChunkL = pOverL+iChunk;
+			float *pChunkR = pOverR+iChunk;
+
+			float amountStep, driveStep, offsetStep, postDriveStep, postWetStep;
+			float amount    = AdvanceParameter(m_curTubeDist,   numChunkSamples, amountStep);
+			float drive     = AdvanceParameter(m_curTubeDrive,  numChunkSamples, driveStep);
+			float offset    = AdvanceParameter(m_curTubeOffset, numChunkSamples, offsetStep);
+			float postDrive = AdvanceParameter(m_curPostDrive,  numChunkSamples, postDriveStep);
+			float postWet   = AdvanceParameter(m_curPostWet,    numChunkSamples, postWetStep);
+
+			// Filters interpolate their coefficients themselves
+			m_curTubeTone.Skip(numChunkSamples);
+			m_curPostCutoff.Skip(numChunkSamples);
+			m_curPostReso.Skip(numChunkSamples);
+
+			const float toneHz = SVF_CutoffToHz(m_curTubeTone.Get(), m_Nyquist);
+
+			// Apply tone filter (resonant LPF) & drive
+			for (unsigned iSample = 0; iSample < numChunkSamples; ++iSample)
+			{
+				drive  += driveStep;
+				offset += offsetStep;
+
+				float sampleL = pChunkL[iSample];
+				float sampleR = pChunkR[iSample];
+
+				m_tubeToneFilter.Update(toneHz, toneQ, SvfLinearTrapOptimised2::LOW_PASS_FILTER, m_sampleRateOS, kPostControlRate);
+				m_tubeToneFilter.Tick(sampleL, sampleR);
+
+				distortedL[iSample] = (offset+sampleL)*drive;
+				distortedR[iSample] = (offset+sampleR)*drive;
+			}
+
+			// Apply (soft) clipping
+			ZoelzerClipBlock(distortedL, numChunkSamples);
+			ZoelzerClipBlock(distortedR, numChunkSamples);
+
+			for (unsigned iSample = 0; iSample < numChunkSamples; ++iSample)
+			{
+				amount    += amountStep;
+				postDrive += postDriveStep;
+
+				// Remove possible DC offset
+				m_tubeDCBlocker.Apply(distortedL[iSample], distortedR[iSample]);
+
+				// Add to signal
+				const float postDistortedL = lerpf<float>(pChunkL[iSample], distortedL[iSample], amount);
+				const float postDistortedR = lerpf<float>(pChunkR[iSample], distortedR[iSample], amount);
+
+				pChunkL[iSample] = postDistortedL;
+				pChunkR[iSample] = postDistortedR;
+
+				// Drive 24dB post filter
+				filteredL[iSample] = postDistortedL*postDrive;
+				filteredR[iSample] = postDistortedR*postDrive;
+			}
+
+			// Saturate to within [-1..1] in order not to blow up the filter
+			ZoelzerClipBlock(filteredL, numChunkSamples);
+			ZoelzerClipBlock(filteredR, numChunkSamples);
+
+			// Apply 24dB post filter
+			m_postFilter.SetParameters(kMinPostFilterCutoffHz + m_curPostCutoff.Get()*kPostFilterCutoffRange, m_curPostReso.Get() /* [0..1] */);
+			m_postFilter.Apply(filteredL, filteredR, numChunkSamples);
+
+			// Blend
+			for (unsigned iSample = 0; iSample < numChunkSamples; ++iSample)
+			{
+				postWet += postWetStep;
+
+				pChunkL[iSample] = lerpf<float>(pChunkL[iSample], filteredL[iSample], postWet);
+				pChunkR[iSample] = lerpf<float>(pChunkR[iSample], filteredR[iSample], postWet);
+			}
+		}
+
+		// Downsample result
+		m_oversampler.Downsample(m_pBufL, m_pBufR, numSamples);
 	}
 
 	/* ----------------------------------------------------------------------------------------------------
 
-		Chorus/Phaser impl.
+		Chorus impl.
 
-		FIXME: these are *old* and could use a review or rewrite
+		FIXME: this is *old* and could use a review or rewrite
 
 	 ------------------------------------------------------------------------------------------------------ */
 
@@ -533,38 +716,4 @@ namespace SFM
 		outL = sampleL + wetness*chorusL; 
 		outR = sampleR + wetness*chorusR; 
 	}
-
-	void PostPass::ApplyPhaser(float sampleL, float sampleR, float &outL, float &outR, float wetness)
-	{
-		// Sweep LFO (filtered for pleasing effect)
-		const float sweepMod = m_phaserSweepLPF.Apply(oscTriangle(m_phaserSweep.Sample()));
-		
-		// Sweep cutoff frequency around center
-		constexpr float range = 0.2f;
-		static_assert(range < 0.5f);
-		const float normCutoff = 0.5f + range*sweepMod;
-		
-		// Start with dry sample
-		float filteredL = sampleL;
-		float filteredR = sampleR;
-
-		// Cutoff & Q
-		const float cutoffHz = SVF_CutoffToHz(normCutoff, m_Nyquist);
-		float Q = kSVFLowestFilterQ; // FIXME: use higher Q?
-		
-		// Apply cascading filters
-		for (auto &filter : m_allpassFilters)
-		{
-			filter.updateAllpassCoeff(cutoffHz, Q, m_sampleRate);
-			filter.tick(filteredL, filteredR);
-
-			// Adds a little "space"
-			Q += Q;
-		}
-		
-		// Add result to dry signal
-		wetness *= kMaxChorusPhaserWet;
-		outL = sampleL + wetness*filteredL;
-		outR = sampleR + wetness*filteredR;
-	}
 }
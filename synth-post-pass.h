@@ -6,19 +6,14 @@
 
 	FIXME:
 		- Almost the entire path is implemented in Apply(), chop this up into smaller pieces?
-		- Write own (or adapt public domain) up- and downsampling routines (currently using JUCE's)
 		- The list of parameters is rather huge, pass through a structure?
 */
 
 #pragma once
 
 #include "3rdparty/filters/SvfLinearTrapOptimised2.hpp"
-#include "3rdparty/filters/MusicDSPModel.h"
 #include "3rdparty/filters/Biquad.h"
 
-// Include JUCE (for juce::dsp::Oversampling)
-#include <JuceHeader.h>
-
 #include "synth-global.h"
 #include "synth-delay-line.h"
 #include "synth-phase.h"
@@ -28,15 +23,22 @@
 #include "synth-compressor.h"
 #include "synth-auto-wah-vox.h"
 #include "synth-mini-EQ.h"
+#include "synth-oversampler.h"
+#include "synth-phaser.h"
+#include "synth-post-kernel.h"
+#include "synth-control-rate-SVF.h"
 
 namespace SFM
 {
-	const unsigned kNumPhaserStages = 8;
+	// Default oversampling for tube distortion & post filter (see Oversampler)
+	constexpr unsigned kDefPostOversamplingStages = 2; // 4X
+	constexpr Oversampler::Design kDefPostOversamplingDesign = Oversampler::kFIR;
 
 	class PostPass
 	{
 	public:
-		PostPass(unsigned sampleRate, unsigned maxSamplesPerBlock, unsigned Nyquist);
+		PostPass(unsigned sampleRate, unsigned maxSamplesPerBlock, unsigned Nyquist,
+		         unsigned oversamplingStages = kDefPostOversamplingStages, Oversampler::Design oversamplingDesign = kDefPostOversamplingDesign);
 		~PostPass();
 
 		// FIXME: this parameter list is just too ridiculously long!
@@ -61,9 +63,24 @@ namespace SFM
 			return bite;
 		}
 		
-		// Returns approx. latency in samples
+		// Returns latency in samples
 		float GetLatency() const;
 
+		// Advances LFO phases (delay, chorus & phaser) whilst not applied
+		void SkipFreeRunning(uint64_t numSamples)
+		{
+			m_tapeDelayLFO.Skip(numSamples);
+			m_chorusSweep.Skip(numSamples);
+			m_chorusSweepMod.Skip(numSamples);
+			m_phaser.SkipFreeRunning(numSamples);
+		}
+
+		// Input, output & all effect tails are silent (see SilenceDetect)
+		bool IsSilent() const
+		{
+			return true == m_silence.IsSilent() && true == m_delayTail.IsSilent() && true == m_wah.IsSilent() && true == m_reverb.IsSilent();
+		}
+
 	private:
 		SFM_INLINE void SetChorusRate(float rate /* [0..1] */, float scale)
 		{
@@ -80,15 +97,15 @@ namespace SFM
 		{
 			rate *= scale;
 
-			m_phaserSweep.SetFrequency(rate);
+			m_phaser.SetRate(rate);
 		}
 		
+		void ApplyOversampled(unsigned numSamples, float toneQ);
 		void ApplyChorus(float sampleL, float sampleR, float &outL, float &outR, float wetness);
-		void ApplyPhaser(float sampleL, float sampleR, float &outL, float &outR, float wetness);
 		
 		const unsigned m_sampleRate;
 		const unsigned m_Nyquist;
-		const unsigned m_sampleRate4X; // Convenience
+		const unsigned m_sampleRateOS; // Oversampled rate (convenience)
 
 		// Intermediate buffers
 		float *m_pBufL = nullptr;
@@ -107,6 +124,7 @@ namespace SFM
 		InterpolatedParameter<kLinInterpolate, true> m_curDelayFeedback;
 		InterpolatedParameter<kLinInterpolate, true> m_curDelayFeedbackCutoff;
 		InterpolatedParameter<kLinInterpolate, true> m_curDelayTapeWow;
+		SilenceDetect m_delayTail;
 
 		// Chorus
 		DelayLine m_chorusDL;
@@ -114,15 +132,22 @@ namespace SFM
 		SinglePoleLPF m_chorusSweepLPF1, m_chorusSweepLPF2;
 
 		// Phaser
-		SvfLinearTrapOptimised2 m_allpassFilters[kNumPhaserStages];
-		Phase m_phaserSweep;
-		SinglePoleLPF m_phaserSweepLPF;
+		Phaser m_phaser;
 
-		// Oversampling (JUCE, FIXME)
-		juce::dsp::Oversampling<float> m_oversampling4X;
+		// Oversampling (tube distortion & post filter)
+		Oversampler m_oversampler;
+
+		// Bypass (pure delay matching the oversampler's latency) & cross-fade
+		const unsigned m_oversamplingBypassDelay;
+		DelayLine m_oversamplingBypassL, m_oversamplingBypassR;
+		float *m_pBypassL = nullptr;
+		float *m_pBypassR = nullptr;
+		bool m_oversampling = false;
+		unsigned m_oversamplingWarmUp = 0;
+		InterpolatedParameter<kLinInterpolate, true> m_curOversamplingMix;
 
 		// Post filter & interpolated parameters
-		MusicDSPMoog m_postFilter;
+		PostLadder m_postFilter;
 		InterpolatedParameter<kLinInterpolate, true> m_curPostCutoff;
 		InterpolatedParameter<kLinInterpolate, true> m_curPostReso;
 		InterpolatedParameter<kLinInterpolate, false> m_curPostDrive;
@@ -133,7 +158,7 @@ namespace SFM
 		InterpolatedParameter<kLinInterpolate, false> m_curTubeDrive;
 		InterpolatedParameter<kLinInterpolate, false> m_curTubeOffset;
 		InterpolatedParameter<kLinInterpolate, true> m_curTubeTone; // Normalized cutoff
-		SvfLinearTrapOptimised2 m_tubeToneFilter;
+		ControlRateSVF m_tubeToneFilter;
 		StereoDCBlocker m_tubeDCBlocker;	
 		
 		// Post
@@ -152,5 +177,8 @@ namespace SFM
 		InterpolatedParameter<kLinInterpolate, true> m_curChorusWet;
 		InterpolatedParameter<kLinInterpolate, true> m_curPhaserWet;
 		InterpolatedParameter<kLinInterpolate, false> m_curMasterVol;
+
+		// Input & output silence, covers the stages with a short memory (chorus, oversampling, compressor, EQ)
+		SilenceDetect m_silence;
 	};
 }
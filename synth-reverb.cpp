@@ -52,6 +52,30 @@ namespace SFM
 	// Pre-delay line length (in seconds)
 	constexpr float kReverbPreDelayLen = 0.5f; // 500MS
 
+	// Longest path through pre-delay, combs & all passes (in samples)
+	static unsigned GetTailLength(unsigned sampleRate)
+	{
+		const size_t stereoSpread = ScaleNumSamples(sampleRate, kStereoSpread);
+
+		size_t length = size_t(sampleRate*kReverbPreDelayLen);
+		length += ScaleNumSamples(sampleRate, *std::max_element(kCombSizes, kCombSizes+kReverbNumCombs)) + stereoSpread;
+
+		for (auto size : kAllPassSizes)
+			length += ScaleNumSamples(sampleRate, size) + stereoSpread;
+
+		return unsigned(length);
+	}
+
+	// Power of 2 that holds 'length' samples, so that the read index can be wrapped with a mask
+	static unsigned GetPaddedLength(size_t length)
+	{
+		unsigned size = 1;
+		while (size < length)
+			size <<= 1;
+
+		return size;
+	}
+
 	Reverb::Reverb(unsigned sampleRate, unsigned Nyquist) :
 		m_sampleRate(sampleRate), m_Nyquist(Nyquist)
 ,		m_preEQ(sampleRate, false)
@@ -66,6 +90,7 @@ namespace SFM
 ,		m_curPreDelay(0.f, sampleRate, kDefParameterLatency * 4.f /* Longer */, 0.f, 1.f)
 ,		m_curBassdB(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
 ,		m_curTrebledB(0.f, sampleRate, kDefParameterLatency, 0.f, 1.f)
+,		m_tail(GetTailLength(sampleRate))
 	{
 		// Semi-fixed
 		static_assert(8 == kReverbNumCombs);
@@ -74,49 +99,201 @@ namespace SFM
 		// Adjusted stereo spread
 		const size_t stereoSpread = ScaleNumSamples(sampleRate, kStereoSpread);
 		
-		// Allocate single sequential buffer
-		size_t totalBufSize = 0;
-		
-		for (auto size : kCombSizes)
+		// Set delays (R is a little longer)
+		size_t longestComb = 0, longestAllPass = 0;
+
+		for (unsigned iComb = 0; iComb < kReverbNumCombs; ++iComb)
 		{
-			size = ScaleNumSamples(sampleRate, size);
-			totalBufSize += size + (size+stereoSpread);
+			const size_t size = ScaleNumSamples(sampleRate, kCombSizes[iComb]);
+			SFM_ASSERT(size > 0);
+
+			m_combDelays[iComb]                 = unsigned(size);
+			m_combDelays[kReverbNumCombs+iComb] = unsigned(size+stereoSpread);
+
+			longestComb = std::max<size_t>(longestComb, size+stereoSpread);
 		}
 		
-		for (auto size : kAllPassSizes)
+		for (unsigned iAllPass = 0; iAllPass < kReverbNumAllPasses; ++iAllPass)
 		{
-			size = ScaleNumSamples(sampleRate, size);
-			totalBufSize += size + (size+stereoSpread);
+			const size_t size = ScaleNumSamples(sampleRate, kAllPassSizes[iAllPass]);
+			SFM_ASSERT(size > 0);
+
+			m_allPassDelays[iAllPass*2]     = unsigned(size);
+			m_allPassDelays[iAllPass*2 + 1] = unsigned(size+stereoSpread);
+
+			longestAllPass = std::max<size_t>(longestAllPass, size+stereoSpread);
 		}
 		
-		m_totalBufSize = totalBufSize*sizeof(float);
-		m_buffer = reinterpret_cast<float*>(mallocAligned(m_totalBufSize, 16));
-		
-		// Set sizes and pointers
-		size_t offset = 0;
-		
-		for (unsigned iComb = 0; iComb < kReverbNumCombs; ++iComb)
+		// Allocate (padded) delay lines
+		const unsigned combLength    = GetPaddedLength(longestComb);
+		const unsigned allPassLength = GetPaddedLength(longestAllPass);
+
+		m_combMask    = combLength-1;
+		m_allPassMask = allPassLength-1;
+
+		m_combs     = reinterpret_cast<float*>(mallocAligned(kReverbCombLanes*combLength*sizeof(float), 16));
+		m_allPasses = reinterpret_cast<float*>(mallocAligned(kReverbAllPassLanes*allPassLength*sizeof(float), 16));
+
+		Reset();
+	}
+
+	void Reverb::Reset()
+	{
+		m_preDelayLine.Reset();
+
+		memset(m_combs, 0, kReverbCombLanes*(m_combMask+1)*sizeof(float));
+		memset(m_allPasses, 0, kReverbAllPassLanes*(m_allPassMask+1)*sizeof(float));
+
+		for (unsigned iLane = 0; iLane < kReverbCombLanes; ++iLane)
+			m_combPrevious[iLane] = 0.f;
+
+		m_tail.Reset();
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Combs & all passes
+
+		Lane N reads what was written m_combDelays[N] (or m_allPassDelays[N]) samples ago and writes at
+		m_writeIdx; the delay lines aren't touched by SIMD, the filter math is
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+#if defined(SFM_SIMD_REVERB)
+
+	SFM_INLINE void Reverb::ApplyCombs(float monaural, float feedback, float dampening, float &outL, float &outR)
+	{
+		static_assert(16 == kReverbCombLanes);
+
+		const unsigned length = m_combMask+1;
+
+		alignas(16) float current[kReverbCombLanes];
+		for (unsigned iLane = 0; iLane < kReverbCombLanes; ++iLane)
+			current[iLane] = m_combs[iLane*length + ((m_writeIdx - m_combDelays[iLane]) & m_combMask)];
+
+		const __m128 input = _mm_set1_ps(monaural);
+		const __m128 fb = _mm_set1_ps(feedback);
+		const __m128 damp1 = _mm_set1_ps(1.f-dampening);
+		const __m128 damp2 = _mm_set1_ps(dampening);
+
+		__m128 cur[4];
+		alignas(16) float write[kReverbCombLanes];
+
+		for (unsigned iReg = 0; iReg < 4; ++iReg)
 		{
-			const size_t size = ScaleNumSamples(sampleRate, kCombSizes[iComb]);
-			float *pCur = m_buffer+offset;
-			m_combsL[iComb].SetSizeAndBuffer(size, pCur);
-			m_combsR[iComb].SetSizeAndBuffer(size+stereoSpread, pCur+size);
-			offset += size + (size+stereoSpread);
+			cur[iReg] = _mm_load_ps(current + iReg*4);
+
+			// Dampening (one-pole LPF) in feedback path
+			const __m128 previous = _mm_add_ps(_mm_mul_ps(cur[iReg], damp1), _mm_mul_ps(_mm_load_ps(m_combPrevious + iReg*4), damp2));
+			_mm_store_ps(m_combPrevious + iReg*4, previous);
+			_mm_store_ps(write + iReg*4, _mm_add_ps(input, _mm_mul_ps(fb, previous)));
 		}
-		
+
+		const unsigned writeIdx = m_writeIdx & m_combMask;
+		for (unsigned iLane = 0; iLane < kReverbCombLanes; ++iLane)
+			m_combs[iLane*length + writeIdx] = write[iLane];
+
+		// Sum: [L, L, R, R] (pairwise)
+		const __m128 sumL = _mm_add_ps(cur[0], cur[1]);
+		const __m128 sumR = _mm_add_ps(cur[2], cur[3]);
+		const __m128 sumLR = _mm_add_ps(_mm_unpacklo_ps(sumL, sumR), _mm_unpackhi_ps(sumL, sumR)); // [L0+L2, R0+R2, L1+L3, R1+R3]
+		const __m128 sum = _mm_add_ps(sumLR, _mm_movehl_ps(sumLR, sumLR));
+
+		outL = _mm_cvtss_f32(sum);
+		outR = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+	}
+
+	SFM_INLINE void Reverb::ApplyAllPasses(float &sampleL, float &sampleR)
+	{
+		const unsigned length = m_allPassMask+1;
+		const unsigned writeIdx = m_writeIdx & m_allPassMask;
+
+		const __m128 feedback = _mm_set1_ps(kAllPassDefFeedback);
+
+		// Lanes: L, R (& 2 unused)
+		__m128 sample = _mm_unpacklo_ps(_mm_set_ss(sampleL), _mm_set_ss(sampleR));
+
 		for (unsigned iAllPass = 0; iAllPass < kReverbNumAllPasses; ++iAllPass)
 		{
-			const size_t size = ScaleNumSamples(sampleRate, kAllPassSizes[iAllPass]);
-			float *pCur = m_buffer + offset;
-			m_allPassesL[iAllPass].SetSizeAndBuffer(size, pCur);
-			m_allPassesR[iAllPass].SetSizeAndBuffer(size+stereoSpread, pCur+size);
-			offset += size + (size+stereoSpread);
+			const unsigned iLaneL = iAllPass*2, iLaneR = iLaneL+1;
+			float *pL = m_allPasses + iLaneL*length;
+			float *pR = m_allPasses + iLaneR*length;
+
+			const __m128 current = _mm_unpacklo_ps(
+				_mm_load_ss(pL + ((m_writeIdx - m_allPassDelays[iLaneL]) & m_allPassMask)),
+				_mm_load_ss(pR + ((m_writeIdx - m_allPassDelays[iLaneR]) & m_allPassMask)));
+
+			const __m128 write = _mm_add_ps(sample, _mm_mul_ps(current, feedback));
+			_mm_store_ss(pL + writeIdx, write);
+			_mm_store_ss(pR + writeIdx, _mm_shuffle_ps(write, write, _MM_SHUFFLE(1, 1, 1, 1)));
+
+			sample = _mm_sub_ps(current, sample);
 		}
-		
-		// Clear buffer
-		memset(m_buffer, 0, m_totalBufSize);
+
+		sampleL = _mm_cvtss_f32(sample);
+		sampleR = _mm_cvtss_f32(_mm_shuffle_ps(sample, sample, _MM_SHUFFLE(1, 1, 1, 1)));
+	}
+
+#else
+
+	SFM_INLINE void Reverb::ApplyCombs(float monaural, float feedback, float dampening, float &outL, float &outR)
+	{
+		const unsigned length = m_combMask+1;
+		const unsigned writeIdx = m_writeIdx & m_combMask;
+
+		const float damp1 = 1.f-dampening;
+		const float damp2 = dampening;
+
+		float current[kReverbCombLanes];
+
+		for (unsigned iLane = 0; iLane < kReverbCombLanes; ++iLane)
+		{
+			float *pLine = m_combs + iLane*length;
+			current[iLane] = pLine[(m_writeIdx - m_combDelays[iLane]) & m_combMask];
+
+			// Dampening (one-pole LPF) in feedback path
+			float &previous = m_combPrevious[iLane];
+			previous = current[iLane]*damp1 + previous*damp2;
+			pLine[writeIdx] = monaural + feedback*previous;
+		}
+
+		// Sum (same order as SIMD path)
+		float sum[4][2];
+		for (unsigned iLane = 0; iLane < 4; ++iLane)
+		{
+			sum[iLane][0] = current[iLane]   + current[iLane+4];
+			sum[iLane][1] = current[iLane+8] + current[iLane+12];
+		}
+
+		outL = (sum[0][0] + sum[2][0]) + (sum[1][0] + sum[3][0]);
+		outR = (sum[0][1] + sum[2][1]) + (sum[1][1] + sum[3][1]);
 	}
 
+	SFM_INLINE void Reverb::ApplyAllPasses(float &sampleL, float &sampleR)
+	{
+		const unsigned length = m_allPassMask+1;
+		const unsigned writeIdx = m_writeIdx & m_allPassMask;
+
+		float *pSamples[2] = { &sampleL, &sampleR };
+
+		for (unsigned iAllPass = 0; iAllPass < kReverbNumAllPasses; ++iAllPass)
+		{
+			for (unsigned iChan = 0; iChan < 2; ++iChan)
+			{
+				const unsigned iLane = iAllPass*2 + iChan;
+				float *pLine = m_allPasses + iLane*length;
+
+				float &sample = *pSamples[iChan];
+
+				const float current = pLine[(m_writeIdx - m_allPassDelays[iLane]) & m_allPassMask];
+				pLine[writeIdx] = sample + current*kAllPassDefFeedback;
+				sample = current - sample;
+			}
+		}
+	}
+
+#endif
+
 	constexpr float kFixedGain = 0.015f; // Taken from ref. implementation 
 
 	void Reverb::Apply(float *pLeft, float *pRight, unsigned numSamples, float wet, float bassTuningdB, float trebleTuningdB)
@@ -135,63 +312,80 @@ namespace SFM
 
 		m_preEQ.SetTargetdBs(bassTuningdB, trebleTuningdB);
 
-		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		// Bypass (output equals input) if muted or if the input is silent and so is the tail
+		const bool isMuted = true == m_curWet.IsDone() && 0.f == m_curWet.Get();
+		if (true == isMuted || (true == m_tail.IsSilent() && GetRectifiedMaximum(pLeft, pRight, numSamples) <= kInfLin))
 		{
-			const float curWet = m_curWet.Sample() * kMaxReverbWet; // Doesn't sound like much if fully open, consider different mix below? (FIXME)
-			const float dry = 1.f-curWet;
-
-			// Stereo (width) effect
-			const float width = m_curWidth.Sample();
-			const float wet1  = curWet*(width*0.5f + 0.5f);
-			const float wet2  = curWet*((1.f-width)*0.5f);
-			
-			// In & out
-			const float inL = *pLeft;
-			const float inR = *pRight;
-
-			float outL = 0.f;
-			float outR = 0.f;
-
-			// Mix to monaural & apply EQ
-			/* const */ float monaural = 0.5f*inR + 0.5f*inL;
-			monaural = m_preEQ.ApplyMono(monaural);
-
-			// Apply pre-delay			
-			m_preDelayLine.Write(monaural);
-			monaural = m_preDelayLine.ReadNormalized(m_curPreDelay.Sample()) * kFixedGain;
-
-			// Accumulate comb filters in parallel
+			// The tail is inaudible whilst muted; drop it so it won't resurface when wet goes up again
+			if (false == m_tail.IsSilent())
+				Reset();
+
+			// Keep parameters in pace
+			m_curWet.Skip(numSamples);
+			m_curWidth.Skip(numSamples);
+			m_curRoomSize.Skip(numSamples);
+			m_curDampening.Skip(numSamples);
+			m_curPreDelay.Skip(numSamples);
+
+			return;
+		}
+
+		float inputPeak = 0.f, tailPeak = 0.f;
+
+		unsigned iSample = 0;
+		while (iSample < numSamples)
+		{
+			const unsigned numSubSamples = std::min<unsigned>(kReverbControlRate, numSamples-iSample);
+
+			// Dampening & room size (comb feedback) are constant for this sub-block
 			const float dampening = m_curDampening.Sample();
 			const float roomSize  = m_curRoomSize.Sample();
+			m_curDampening.Skip(numSubSamples-1);
+			m_curRoomSize.Skip(numSubSamples-1);
 
-			for (unsigned iComb = 0; iComb < kReverbNumCombs; ++iComb)
-			{ 
-				auto &combL = m_combsL[iComb];
-				auto &combR = m_combsR[iComb];
+			SFM_ASSERT(dampening >= 0.f && dampening < 1.f);
 
-				combL.SetDampening(dampening);
-				combR.SetDampening(dampening);
+			for (const unsigned iEnd = iSample+numSubSamples; iSample < iEnd; ++iSample)
+			{
+				const float curWet = m_curWet.Sample() * kMaxReverbWet; // Doesn't sound like much if fully open, consider different mix below? (FIXME)
+				const float dry = 1.f-curWet;
 
-				outL += combL.Apply(monaural, roomSize);
-				outR += combR.Apply(monaural, roomSize);
-			}
+				// Stereo (width) effect
+				const float width = m_curWidth.Sample();
+				const float wet1  = curWet*(width*0.5f + 0.5f);
+				const float wet2  = curWet*((1.f-width)*0.5f);
+				
+				// In & out
+				const float inL = pLeft[iSample];
+				const float inR = pRight[iSample];
 
-			// Apply remaining all pass filters in series
-			for (unsigned iAllPass = 0; iAllPass < kReverbNumAllPasses; ++iAllPass)
-			{
-				auto &passL = m_allPassesL[iAllPass];
-				auto &passR = m_allPassesR[iAllPass];
-			
-				outL = passL.Apply(outL, kAllPassDefFeedback);
-				outR = passR.Apply(outR, kAllPassDefFeedback);
-			}
+				float outL, outR;
+
+				// Mix to monaural & apply EQ
+				/* const */ float monaural = 0.5f*inR + 0.5f*inL;
+				monaural = m_preEQ.ApplyMono(monaural);
 
-			// Mix
-			const float left  = outL*wet1 + outR*wet2 + inL*dry;
-			const float right = outR*wet1 + outL*wet2 + inR*dry;
+				// Apply pre-delay			
+				m_preDelayLine.Write(monaural);
+				monaural = m_preDelayLine.ReadNormalized(m_curPreDelay.Sample()) * kFixedGain;
 
-			*pLeft++  = left;
-			*pRight++ = right;
+				// Accumulate comb filters in parallel
+				ApplyCombs(monaural, roomSize, dampening, outL, outR);
+
+				// Apply remaining all pass filters in series
+				ApplyAllPasses(outL, outR);
+
+				++m_writeIdx;
+
+				inputPeak = std::max<float>(inputPeak, GetRectifiedMaximum(inL, inR));
+				tailPeak  = std::max<float>(tailPeak,  GetRectifiedMaximum(outL, outR));
+
+				// Mix
+				pLeft[iSample]  = outL*wet1 + outR*wet2 + inL*dry;
+				pRight[iSample] = outR*wet1 + outL*wet2 + inR*dry;
+			}
 		}
+
+		m_tail.Run(inputPeak, tailPeak, numSamples);
 	}
 }
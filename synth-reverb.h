@@ -4,6 +4,13 @@
 	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
 	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
 
+	- The parallel combs of both channels (16 in total) are processed side by side in SSE lanes, followed by
+	  the left & right all-pass chain in 2 lanes; results are bit-identical to the scalar path, so they can be
+	  A/B'd (define SFM_DISABLE_SIMD_REVERB)
+	- Each delay line is padded to a power of 2 and all share a single write index, so wrapping around is a
+	  mask instead of a modulo
+	- Dampening & room size are updated once every kReverbControlRate samples
+
 	FIXME:
 		- Supply all parameters at once using a single SetParameters() function
 */
@@ -11,126 +18,31 @@
 #pragma once
 
 #include "synth-global.h"
+
+#if !defined(SFM_DISABLE_SIMD_REVERB) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define SFM_SIMD_REVERB
+	#include <emmintrin.h>
+#endif
+
 #include "synth-oscillator.h"
 #include "synth-interpolated-parameter.h"
 #include "synth-delay-line.h"
 #include "synth-mini-EQ.h"
+#include "synth-level-detect.h"
 
 namespace SFM
 {
-	// Specific delay line essentially; this one does not own it's buffer!
-	class ReverbComb
-	{
-	public:
-		ReverbComb() :
-			m_size(0), m_buffer(nullptr), m_writeIdx(0), m_dampening(0.f), m_previous(0.f)
-		{}
-
-		~ReverbComb() {}
-		
-		void SetSizeAndBuffer(size_t size, float *pBuffer)
-		{
-			SFM_ASSERT(size > 0);
-			SFM_ASSERT(nullptr != pBuffer);
-			
-			m_size = size;
-			m_buffer = pBuffer;
-			
-			Reset();
-		}
-
-		void Reset()
-		{
-			SFM_ASSERT(nullptr != m_buffer);
-			memset(m_buffer, 0, m_size*sizeof(float));
-		}
-		
-		void SetDampening(float value)
-		{
-			SFM_ASSERT(value >= 0.f && value < 1.f);
-			m_dampening = value;
-		}
-
-		SFM_INLINE float Apply(float sample, float feedback = 0.f)
-		{
-			SFM_ASSERT(nullptr != m_buffer);
-			
-			const unsigned index = m_writeIdx % m_size;
-			
-			const float current = m_buffer[index];
-			m_previous = current*(1.f-m_dampening) + (m_previous*m_dampening);
-			m_buffer[index] = sample + feedback*m_previous;
-
-			++m_writeIdx;
-
-			return current;
-		}
-
-		size_t size() const { return m_size; }
-
-	private:
-		size_t m_size;
-		float *m_buffer;
-		unsigned m_writeIdx;
-		
-		float m_dampening;
-		float m_previous;
-	};
-
-	// Roughly follows the same design as ReverbComb
-	class ReverbAllPass
-	{
-	public:
-		ReverbAllPass() :
-			m_size(0), m_buffer(nullptr), m_writeIdx(0)
-		{}
-
-		~ReverbAllPass() {}
-
-		void SetSizeAndBuffer(size_t size, float *pBuffer)
-		{
-			SFM_ASSERT(size > 0);
-			SFM_ASSERT(nullptr != pBuffer);
-			
-			m_size = size;
-			m_buffer = pBuffer;
-			
-			Reset();
-		}
-
-		void Reset()
-		{
-			SFM_ASSERT(nullptr != m_buffer);
-			memset(m_buffer, 0, m_size*sizeof(float));
-		}
-
-		SFM_INLINE float Apply(float sample, float feedback = 0.f)
-		{
-			SFM_ASSERT(nullptr != m_buffer);
-			
-			const unsigned index = m_writeIdx % m_size;
-			
-			const float current = m_buffer[index];
-			const float output = -sample + current;
-			m_buffer[index] = sample + (current*feedback);
-			
-			++m_writeIdx;
-
-			return output;
-		}
-
-		size_t size() const { return m_size; }
-
-	private:
-		size_t m_size;
-		float *m_buffer;
-		unsigned m_writeIdx;
-	};
-
 	// Warning: you can't just change these!
 	constexpr unsigned kReverbNumCombs = 8;
 	constexpr unsigned kReverbNumAllPasses = 4;
 
+	// Lanes (L & R) per row of the delay lines
+	constexpr unsigned kReverbCombLanes = kReverbNumCombs*2;
+	constexpr unsigned kReverbAllPassLanes = kReverbNumAllPasses*2;
+
+	// Samples per dampening & room size update
+	constexpr unsigned kReverbControlRate = 32;
+
 	// Max. room size to prevent infinite reverberation
 	constexpr float kReverbMaxRoomSize = 0.9f;
 
@@ -141,7 +53,8 @@ namespace SFM
 		
 		~Reverb()
 		{
-			freeAligned(m_buffer);
+			freeAligned(m_combs);
+			freeAligned(m_allPasses);
 		}
 	
 	public:
@@ -177,9 +90,23 @@ namespace SFM
 		}
 
 		// Samples are read & written sequentially so one buffer per channel suffices
+		// Bypassed whilst wet is zero (tail is dropped) or input and tail are silent
 		void Apply(float *pLeft, float *pRight, unsigned numSamples, float wet, float bassTuning, float trebleTuning);
 
+		bool IsSilent() const
+		{
+			return m_tail.IsSilent();
+		}
+
 	private:
+		void Reset();
+
+		// Returns sum of comb outputs (L & R)
+		SFM_INLINE void ApplyCombs(float monaural, float feedback, float dampening, float &outL, float &outR);
+
+		// Applies all passes (in series) to L & R
+		SFM_INLINE void ApplyAllPasses(float &sampleL, float &sampleR);
+
 		const unsigned m_sampleRate;
 		const unsigned m_Nyquist;
 		const unsigned m_NyquistAt44100 = 44100/2;
@@ -187,8 +114,18 @@ namespace SFM
 		MiniEQ m_preEQ;
 		DelayLine m_preDelayLine;
 
-		ReverbComb m_combsL[kReverbNumCombs], m_combsR[kReverbNumCombs];
-		ReverbAllPass m_allPassesL[kReverbNumAllPasses], m_allPassesR[kReverbNumAllPasses];
+		// Delay lines, one after the other (in lane order, see kReverbCombLanes & kReverbAllPassLanes)
+		float *m_combs = nullptr;
+		float *m_allPasses = nullptr;
+		unsigned m_combMask, m_allPassMask;
+		unsigned m_writeIdx = 0;
+
+		// Delay per lane (in samples); combs: L (0-7), R (8-15), all passes: L & R per stage
+		alignas(16) unsigned m_combDelays[kReverbCombLanes];
+		alignas(16) unsigned m_allPassDelays[kReverbAllPassLanes];
+
+		// Comb dampening filter state
+		alignas(16) float m_combPrevious[kReverbCombLanes];
 
 		// Parameters
 		float m_width;
@@ -204,8 +141,8 @@ namespace SFM
 		InterpolatedParameter<kLinInterpolate, true> m_curPreDelay;
 		InterpolatedParameter<kLinInterpolate, false> m_curBassdB, m_curTrebledB;
 
-		// Single buffer is used for all passes, this likely favors cache (FIXME: check)
-		size_t m_totalBufSize;
-		float *m_buffer;
+		// Input & tail silence (pre-delay, combs & all passes)
+		SilenceDetect m_tail;
+
 	};
 }
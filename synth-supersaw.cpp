@@ -67,5 +67,9 @@ namespace SFM
 		// Set frequency (JP-8000 controls, pitch, filter)
 		m_frequency = 0.f; 
 		SetFrequency(frequency, detune, mix);
+
+		// Pitches depend on sample rate
+		m_pitchFrequency = -1.f;
+		UpdatePitch();
 	}
 }
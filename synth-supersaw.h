@@ -5,7 +5,12 @@
 	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
 
 	- Ref.: https://pdfs.semanticscholar.org/1852/250068e864215dd7f12755cf00636868a251.pdf (copy in repository)
-	- Free running: all phases are updated by Bison::Render() if the oscillator is not being used
+	- Free running: whilst the oscillator is not being used it only remembers when that started (Free()), and
+	  it's phases are brought up to date (Resume()) by Bison once it's voice is (re)triggered
+	- The 7 oscillators are evaluated side by side in 2 SSE registers (8 lanes, the last one unused); AVX2 would fit
+	  them in 1 but the (co)sine table lookup and the sum of the sides are scalar anyway, so SSE2 it is
+	- Results are bit-identical to the scalar path, so they can be A/B'd (define SFM_DISABLE_SIMD_SUPERSAW)
+	- Voice::Sample() sets frequency, detune, mix & bend each sample, pitches are only calculated if they change
 	
 	FIXME:
 		- Not in [-1..1] - is this a problem?
@@ -19,6 +24,12 @@
 #include "3rdparty/filters/Biquad.h"
 
 #include "synth-global.h"
+
+#if !defined(SFM_DISABLE_SIMD_SUPERSAW) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define SFM_SIMD_SUPERSAW
+	#include <emmintrin.h>
+#endif
+
 #include "synth-stateless-oscillators.h"
 #include "synth-one-pole-filters.h"
 
@@ -27,6 +38,9 @@ namespace SFM
 	// Number of oscillators
 	constexpr unsigned kNumSupersawOscillators = 7;
 
+	// Number of oscillators rounded up to SSE register width
+	constexpr unsigned kSupersawLanes = (kNumSupersawOscillators+3) & ~3;
+
 	// Relation between frequencies (slightly asymmetric)
 	// Centre oscillator moved from position 4 to 1
 	constexpr float kSupersawRelative[kNumSupersawOscillators] = 
@@ -83,8 +97,8 @@ namespace SFM
 			m_sampleRate(1) 
 		{
 			// Initialize phases with values between [0..1] and let's hope that at least a few of them are irrational
-			for (auto &phase : m_phase)
-				phase = oscSine(0.11f + 0.1f*mt_randf()); // Should be irrational
+			for (unsigned iOsc = 0; iOsc < kNumSupersawOscillators; ++iOsc)
+				m_phase[iOsc] = oscSine(0.11f + 0.1f*mt_randf()); // Should be irrational
 		}
 
 		void Initialize(float frequency, unsigned sampleRate, float detune, float mix);
@@ -93,32 +107,36 @@ namespace SFM
 		SFM_INLINE void SetFrequency(float frequency, float detune, float mix)
 		{
 			// Set JP-8000 controls
-			SetDetune(detune);
-			SetMix(mix);
+			if (detune != m_detune)
+				SetDetune(detune);
+
+			if (mix != m_mix)
+				SetMix(mix);
 
 			m_frequency = frequency;
-			OnFrequencyChange(m_frequency);
+			m_bend = 1.f;
 		}
 
 		SFM_INLINE void PitchBend(float bend)
 		{
-			// An unnecessary OnFrequencyChange() isn't cheap enough to just disregard
-			if (1.f == bend)
-				return;
-
-			const float frequency = m_frequency*bend;
-			OnFrequencyChange(frequency);
+			m_bend = bend;
 		}
 
 		SFM_INLINE float Sample()
 		{
+			UpdatePitch();
+
+			// Saws minus pure sines (see Oscillate())
+			alignas(16) float saws[kSupersawLanes];
+			OscillateLanes(saws);
+
 			// Centre oscillator
-			const float main = Oscillate(0, false);
+			const float main = saws[0];
 
 			// Side oscillators
 			float sides = 0.f;
 			for (unsigned iOsc = 1; iOsc < kNumSupersawOscillators; ++iOsc)
-				sides += Oscillate(iOsc, (iOsc < kNumSupersawOscillators-1) ? true : false);
+				sides += saws[iOsc];
 
 			float signal = main*m_mainMix + sides*m_sideMix;
 
@@ -128,13 +146,37 @@ namespace SFM
 			return signal;
 		}
 		
-		// Advance phase by a number of samples (used by Bison::Render() for true 'free running') <-- FIXME!
-		SFM_INLINE void Skip(unsigned numSamples)
+		// Advance phases by a number of samples (in double precision, as that number can be huge)
+		SFM_INLINE void Skip(uint64_t numSamples)
 		{
+			UpdatePitch();
+
 			for (unsigned iOsc = 0; iOsc < kNumSupersawOscillators; ++iOsc)
 			{
 				float &phase = m_phase[iOsc];
-				phase = fmodf(phase + numSamples*m_pitch[iOsc], 1.f);
+				phase = float(fmod(phase + double(numSamples)*m_pitch[iOsc], 1.0));
+			}
+		}
+
+		// Not in use as of sample clock 'clock' (see Bison::m_sampleClock)
+		SFM_INLINE void Free(uint64_t clock)
+		{
+			if (false == m_isFree)
+			{
+				m_isFree = true;
+				m_freeSince = clock;
+			}
+		}
+
+		// In use as of 'clock', catch up on the time spent free running
+		SFM_INLINE void Resume(uint64_t clock)
+		{
+			if (true == m_isFree)
+			{
+				SFM_ASSERT(clock >= m_freeSince);
+				Skip(clock-m_freeSince);
+
+				m_isFree = false;
 			}
 		}
 
@@ -154,16 +196,84 @@ namespace SFM
 		unsigned m_sampleRate;
 		float m_frequency = 0.f;
 
+		float m_bend = 1.f;
+
+		float m_detune    = -1.f; // As set (see SetFrequency())
+		float m_mix       = -1.f; //
 		float m_curDetune = 0.f;
 		float m_mainMix   = 0.f; 
 		float m_sideMix   = 0.f;
 
-		float m_phase[kNumSupersawOscillators] = { 0.f };
-		float m_pitch[kNumSupersawOscillators] = { 0.f };
+		// Frequency & detune 'm_pitch' was calculated for
+		float m_pitchFrequency = -1.f;
+		float m_pitchDetune    = -1.f;
+
+		// Unused lane stays zero
+		alignas(16) float m_phase[kSupersawLanes] = { 0.f };
+		alignas(16) float m_pitch[kSupersawLanes] = { 0.f };
+
+		// Free running since (see Free())
+		bool m_isFree = true;
+		uint64_t m_freeSince = 0;
 
 		Biquad m_HPF;
 		DCBlocker m_blocker;
 
+#if defined(SFM_SIMD_SUPERSAW)
+
+		// Advances all phases and writes each PolyBLEP saw (minus it's pure sine, see Oscillate()) to 'saws'
+		SFM_INLINE void OscillateLanes(float *saws)
+		{
+			alignas(16) float phases[kSupersawLanes];
+
+			const __m128 one  = _mm_set1_ps(1.f);
+			const __m128 two  = _mm_set1_ps(2.f);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+			for (unsigned iLane = 0; iLane < kSupersawLanes; iLane += 4)
+			{
+				const __m128 phase = _mm_load_ps(m_phase+iLane);
+				const __m128 pitch = _mm_load_ps(m_pitch+iLane);
+				_mm_store_ps(phases+iLane, phase);
+
+				// Advance phase (like Tick())
+				const __m128 advanced = _mm_add_ps(phase, pitch);
+				const __m128 wrap = _mm_and_ps(_mm_cmpgt_ps(advanced, one), one);
+				_mm_store_ps(m_phase+iLane, _mm_sub_ps(advanced, wrap));
+
+				// Like oscPolySaw(), truncation equals Poly::bitwiseOrZero() since phase is positive
+				const __m128 shifted = _mm_add_ps(phase, half);
+				const __m128 P1 = _mm_sub_ps(shifted, _mm_cvtepi32_ps(_mm_cvttps_epi32(shifted)));
+				const __m128 saw = _mm_sub_ps(_mm_mul_ps(two, P1), one);
+
+				// Poly::BLEP(), both branches (the unused lane divides by zero but is never selected)
+				const __m128 low  = _mm_sub_ps(_mm_div_ps(P1, pitch), one);
+				const __m128 high = _mm_add_ps(_mm_div_ps(_mm_sub_ps(P1, one), pitch), one);
+				const __m128 isLow  = _mm_cmplt_ps(P1, pitch);
+				const __m128 isHigh = _mm_andnot_ps(isLow, _mm_cmpgt_ps(P1, _mm_sub_ps(one, pitch)));
+				const __m128 BLEP = _mm_or_ps(
+					_mm_and_ps(isLow, _mm_xor_ps(sign, _mm_mul_ps(low, low))), 
+					_mm_and_ps(isHigh, _mm_mul_ps(high, high)));
+
+				_mm_store_ps(saws+iLane, _mm_sub_ps(saw, BLEP));
+			}
+
+			// Subtract pure sine (table lookup, per lane)
+			for (unsigned iOsc = 1; iOsc < kNumSupersawOscillators-1; ++iOsc)
+				saws[iOsc] -= oscSine(phases[iOsc]);
+		}
+
+#else
+
+		SFM_INLINE void OscillateLanes(float *saws)
+		{
+			for (unsigned iOsc = 0; iOsc < kNumSupersawOscillators; ++iOsc)
+				saws[iOsc] = Oscillate(iOsc, iOsc > 0 && iOsc < kNumSupersawOscillators-1);
+		}
+
+#endif
+
 		SFM_INLINE float Tick(unsigned iOsc)
 		{
 			SFM_ASSERT(iOsc < kNumSupersawOscillators);
@@ -193,6 +303,20 @@ namespace SFM
 			return polySaw;
 		}
 
+		// Calc. pitches only if (bent) frequency or detune changed
+		SFM_INLINE void UpdatePitch()
+		{
+			const float frequency = m_frequency*m_bend;
+
+			if (frequency != m_pitchFrequency || m_curDetune != m_pitchDetune)
+			{
+				OnFrequencyChange(frequency);
+
+				m_pitchFrequency = frequency;
+				m_pitchDetune = m_curDetune;
+			}
+		}
+
 		SFM_INLINE void OnFrequencyChange(float frequency)
 		{
 			// Calc. pitch for each oscillator
@@ -213,6 +337,8 @@ namespace SFM
 		// Key parameters (detune & mix)
 		SFM_INLINE void SetDetune(float detune /* [0..1] */)
 		{
+			m_detune = detune;
+
 //			m_curDetune = (float) SampleDetuneCurve(detune);
 			m_curDetune = SampleDetuneTable(detune);
 			SFM_ASSERT(m_curDetune >= 0.f && m_curDetune <= 1.f);
@@ -221,6 +347,7 @@ namespace SFM
 		SFM_INLINE void SetMix(float mix /* [0..1] */)
 		{
 			SFM_ASSERT_NORM(mix);
+			m_mix = mix;
 			m_mainMix = -0.55366f*mix + 0.99785f;
 			m_sideMix = -0.73764f*powf(mix, 2.f) + 1.2841f*mix + 0.044372f;
 		}
@@ -0,0 +1,175 @@
+/*
+	FM. BISON hybrid FM synthesis -- Persistent worker thread pool (used to render voices in parallel).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include <chrono>
+
+#include "synth-thread-pool.h"
+
+namespace SFM
+{
+	// Time a worker keeps spinning after it's last batch before it goes to sleep; this should comfortably exceed
+	// the duration of a (reasonably sized) block so that workers stay hot while the host keeps calling Render()
+	constexpr auto kWorkerSpinTime = std::chrono::milliseconds(4);
+
+	// Max. time a sleeping worker waits before it checks for a batch on it's own (covers a missed notification)
+	constexpr auto kWorkerSleepTimeout = std::chrono::milliseconds(10);
+
+	ThreadPool::ThreadPool(unsigned numWorkers /* = kAutoNumWorkers */) :
+		m_generation(0)
+,		m_nextJob(0)
+,		m_jobsDone(0)
+,		m_numBusy(0)
+,		m_numSleeping(0)
+,		m_quit(false)
+	{
+		if (kAutoNumWorkers == numWorkers)
+		{
+			// Can return zero if the number can't be determined
+			const unsigned numCores = std::thread::hardware_concurrency();
+			numWorkers = (numCores > 1) ? numCores-1 : 0;
+		}
+
+		m_numWorkers = std::min<unsigned>(numWorkers, kMaxPoolThreads-1);
+
+		for (unsigned iWorker = 0; iWorker < m_numWorkers; ++iWorker)
+			m_workers[iWorker] = new std::thread(&ThreadPool::WorkerLoop, this, iWorker+1);
+
+		Log("Thread pool started with %u worker(s)", m_numWorkers);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_quit.store(true);
+		}
+
+		m_wakeUp.notify_all();
+
+		for (unsigned iWorker = 0; iWorker < m_numWorkers; ++iWorker)
+		{
+			m_workers[iWorker]->join();
+			delete m_workers[iWorker];
+		}
+	}
+
+	void ThreadPool::Run(JobFunction function, void *pContext, unsigned numJobs)
+	{
+		SFM_ASSERT(nullptr != function);
+
+		if (0 == numJobs)
+			return;
+
+		if (0 == m_numWorkers || 1 == numJobs)
+		{
+			// Not worth the trouble
+			for (unsigned iJob = 0; iJob < numJobs; ++iJob)
+				function(pContext, iJob, 0);
+
+			return;
+		}
+
+		// Generation is even and no worker is busy, so it's safe to set up the batch
+		SFM_ASSERT(0 == (m_generation.load() & 1));
+		SFM_ASSERT(0 == m_numBusy.load());
+
+		m_function = function;
+		m_pContext = pContext;
+		m_numJobs  = numJobs;
+
+		m_nextJob.store(0, std::memory_order_relaxed);
+		m_jobsDone.store(0, std::memory_order_relaxed);
+
+		// Open batch
+		m_generation.fetch_add(1);
+
+		if (m_numSleeping.load() > 0)
+			m_wakeUp.notify_all();
+
+		// Process jobs on this thread too
+		ProcessJobs(0);
+
+		// Wait for jobs still in flight on other threads
+		while (m_jobsDone.load(std::memory_order_acquire) < numJobs)
+			std::this_thread::yield();
+
+		// Close batch and wait for any worker that might still be looking at it
+		m_generation.fetch_add(1);
+
+		while (m_numBusy.load() > 0)
+			std::this_thread::yield();
+	}
+
+	unsigned ThreadPool::ProcessJobs(unsigned iThread)
+	{
+		unsigned numDone = 0;
+
+		for (;;)
+		{
+			const unsigned iJob = m_nextJob.fetch_add(1, std::memory_order_relaxed);
+			if (iJob >= m_numJobs)
+				break;
+
+			m_function(m_pContext, iJob, iThread);
+			++numDone;
+		}
+
+		if (numDone > 0)
+			m_jobsDone.fetch_add(numDone, std::memory_order_release);
+
+		return numDone;
+	}
+
+	void ThreadPool::WorkerLoop(unsigned iThread)
+	{
+#if SFM_KILL_DENORMALS
+		DisableDenormals disableDEN;
+#endif
+
+		unsigned lastGeneration = 0;
+		auto lastBatchTime = std::chrono::steady_clock::now();
+
+		while (false == m_quit.load(std::memory_order_relaxed))
+		{
+			const unsigned generation = m_generation.load(std::memory_order_relaxed);
+
+			if ((generation & 1) && generation != lastGeneration)
+			{
+				// Announce that we're (possibly) going to touch the batch, then check if it's still open
+				m_numBusy.fetch_add(1);
+
+				if (generation == m_generation.load())
+					ProcessJobs(iThread);
+
+				m_numBusy.fetch_sub(1);
+
+				lastGeneration = generation;
+				lastBatchTime = std::chrono::steady_clock::now();
+
+				continue;
+			}
+
+			if (std::chrono::steady_clock::now()-lastBatchTime < kWorkerSpinTime)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Sleep until next batch (or timeout)
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+
+			m_numSleeping.fetch_add(1);
+
+			m_wakeUp.wait_for(lock, kWorkerSleepTimeout, [this, lastGeneration]
+			{
+				const unsigned generation = m_generation.load();
+				return true == m_quit.load() || ((generation & 1) && generation != lastGeneration);
+			});
+
+			m_numSleeping.fetch_sub(1);
+		}
+	}
+}
@@ -0,0 +1,84 @@
+/*
+	FM. BISON hybrid FM synthesis -- Persistent worker thread pool (used to render voices in parallel).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	Replaces spawning (and joining) a std::thread each Render() call, which cost tens of microseconds per block.
+
+	- Workers are started once and stay alive for the lifetime of the pool
+	- Run() publishes a batch of jobs by bumping an atomic generation; the calling (audio) thread never takes a lock
+	- All threads, including the calling one, pull jobs off a shared atomic counter (so idle threads "steal" what's left)
+	- Workers spin (and yield) for a little while after each batch, then fall asleep on a condition variable; the
+	  calling thread only notifies if someone is actually asleep, and since it processes jobs itself a missed
+	  wake-up can never stall a batch, it merely costs parallelism for that one block
+
+	Thread index 0 is always the calling thread, workers are [1..GetNumThreads()-1]; use it to select per-thread buffers.
+*/
+
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "synth-global.h"
+
+namespace SFM
+{
+	// Max. number of threads (including the calling thread) a pool will use, regardless of hardware
+	constexpr unsigned kMaxPoolThreads = 16;
+
+	// Pass to constructor to use std::thread::hardware_concurrency()-1 workers
+	constexpr unsigned kAutoNumWorkers = unsigned(-1);
+
+	class ThreadPool
+	{
+	public:
+		// Job function: 'iJob' is [0..numJobs-1], 'iThread' is [0..GetNumThreads()-1]
+		typedef void (*JobFunction)(void *pContext, unsigned iJob, unsigned iThread);
+
+		ThreadPool(unsigned numWorkers = kAutoNumWorkers);
+		~ThreadPool();
+
+		// Executes all jobs and returns when they're done; do *not* call from more than one thread at a time
+		void Run(JobFunction function, void *pContext, unsigned numJobs);
+
+		SFM_INLINE unsigned GetNumWorkers() const
+		{
+			return m_numWorkers;
+		}
+
+		// Workers plus calling thread
+		SFM_INLINE unsigned GetNumThreads() const
+		{
+			return m_numWorkers+1;
+		}
+
+	private:
+		void WorkerLoop(unsigned iThread);
+
+		// Grab & execute jobs until none are left (returns number of jobs executed)
+		unsigned ProcessJobs(unsigned iThread);
+
+		unsigned m_numWorkers = 0;
+		std::thread *m_workers[kMaxPoolThreads-1] = { nullptr };
+
+		// Current batch (only written by Run() when no worker can be reading it)
+		JobFunction m_function = nullptr;
+		void *m_pContext = nullptr;
+		unsigned m_numJobs = 0;
+
+		// Odd generation means a batch is up for grabs, even means idle
+		alignas(64) std::atomic<unsigned> m_generation;
+		alignas(64) std::atomic<unsigned> m_nextJob;
+		alignas(64) std::atomic<unsigned> m_jobsDone;
+		alignas(64) std::atomic<unsigned> m_numBusy;
+
+		// Sleeping workers
+		std::atomic<unsigned> m_numSleeping;
+		std::atomic<bool> m_quit;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeUp;
+	};
+}
@@ -0,0 +1,225 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Voices rendered in lockstep (voices in SIMD lanes).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include "synth-voice-lanes.h"
+
+namespace SFM
+{
+	/* static */ bool VoiceLanes::IsEligible(const Voice &voice)
+	{
+#if defined(SFM_SIMD_OPERATORS)
+		return false == voice.IsIdle() && 0 == voice.m_sampleOffs && true == voice.m_plainSines;
+#else
+		(void) voice;
+		return false;
+#endif
+	}
+
+	/* static */ bool VoiceLanes::IsCompatible(const Voice &voiceA, const Voice &voiceB)
+	{
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			const Voice::Operator &opA = voiceA.m_operators[iOp];
+			const Voice::Operator &opB = voiceB.m_operators[iOp];
+
+			if (opA.enabled != opB.enabled)
+				return false;
+
+			if (true == opA.enabled)
+			{
+				if (opA.isCarrier != opB.isCarrier || opA.iFeedback != opB.iFeedback)
+					return false;
+
+				for (unsigned iModulator = 0; iModulator < 3; ++iModulator)
+				{
+					if (opA.modulators[iModulator] != opB.modulators[iModulator])
+						return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+#if defined(SFM_SIMD_OPERATORS)
+
+	void VoiceLanes::Load(Voice * const *pVoices, unsigned numVoices)
+	{
+		SFM_ASSERT(nullptr != pVoices);
+		SFM_ASSERT(numVoices > 0 && numVoices <= kVoiceLanes);
+
+		m_numVoices = numVoices;
+
+		for (unsigned iLane = 0; iLane < numVoices; ++iLane)
+		{
+			m_voices[iLane] = pVoices[iLane];
+
+			SFM_ASSERT(true == IsEligible(*m_voices[iLane]));
+			SFM_ASSERT(true == IsCompatible(*m_voices[0], *m_voices[iLane]));
+		}
+
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			OperatorLanes &lanes = m_operators[iOp];
+
+			for (unsigned iLane = 0; iLane < numVoices; ++iLane)
+			{
+				const Voice &voice = *m_voices[iLane];
+				const Voice::Operator &voiceOp = voice.m_operators[iOp];
+
+				lanes.phase[iLane]     = (true == voiceOp.enabled) ? voiceOp.oscillator.GetPhase() : 0.f;
+				lanes.feedback[iLane]  = voiceOp.feedback;
+				lanes.modSample[iLane] = voice.m_modSamples[iOp+1];
+				lanes.carrier[iLane]   = (true == voiceOp.isCarrier) ? -1 : 0;
+			}
+
+			// Unused lanes stay silent
+			const unsigned numPadded = PadOperatorLanes(lanes, numVoices);
+			SFM_ASSERT(kVoiceLanes == numPadded);
+
+			for (unsigned iLane = numVoices; iLane < numPadded; ++iLane)
+				lanes.modSample[iLane] = 0.f;
+		}
+	}
+
+	void VoiceLanes::Store()
+	{
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			const OperatorLanes &lanes = m_operators[iOp];
+
+			for (unsigned iLane = 0; iLane < m_numVoices; ++iLane)
+			{
+				Voice &voice = *m_voices[iLane];
+				Voice::Operator &voiceOp = voice.m_operators[iOp];
+
+				if (true == voiceOp.enabled)
+				{
+					voiceOp.oscillator.GetPhaseObject().Set(lanes.phase[iLane]);
+					voiceOp.feedback = lanes.feedback[iLane];
+					voice.m_modSamples[iOp+1] = lanes.modSample[iLane];
+				}
+			}
+		}
+	}
+
+	void VoiceLanes::Sample(float *pLeft, float *pRight, const float *pPitchBendMul, float ampBend, float modulation, float LFOBlend, float LFOModDepth)
+	{
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight && nullptr != pPitchBendMul);
+		SFM_ASSERT(m_numVoices > 0);
+
+		// Parameter assertions
+		SFM_ASSERT(ampBend >= dB2Lin(-kAmpBendRange) && ampBend <= dB2Lin(kAmpBendRange)); // Linear gain
+		SFM_ASSERT_NORM(modulation);
+		SFM_ASSERT_NORM(LFOBlend);
+		SFM_ASSERT(LFOModDepth >= 0.f);
+
+		// LFO, pitch envelope & bend
+		Voice::VoiceModulation voiceMods[kVoiceLanes];
+		for (unsigned iLane = 0; iLane < m_numVoices; ++iLane)
+			voiceMods[iLane] = m_voices[iLane]->SampleModulation(pPitchBendMul[iLane], LFOBlend, LFOModDepth);
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one  = _mm_set1_ps(1.f);
+
+		__m128 mixL = zero, mixR = zero;
+
+		// Topology is shared, so the first voice's operators will do
+		const Voice &topology = *m_voices[0];
+
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			const Voice::Operator &topOp = topology.m_operators[iOp];
+
+			if (false == topOp.enabled)
+				continue;
+
+			OperatorLanes &lanes = m_operators[iOp];
+
+			// Parameters, frequency & vibrato
+			for (unsigned iLane = 0; iLane < m_numVoices; ++iLane)
+			{
+				Voice &voice = *m_voices[iLane];
+				Voice::Operator &voiceOp = voice.m_operators[iOp];
+
+				const Voice::OperatorParameters opParams = voice.SampleOperator(voiceOp, voiceMods[iLane], modulation);
+				Voice::SetOperatorPitch(voiceOp, opParams);
+
+				lanes.pitch[iLane]        = voiceOp.oscillator.GetPhaseObject().GetPitch();
+				lanes.tremolo[iLane]      = voiceMods[iLane].LFO*voiceOp.ampMod;
+				lanes.envelope[iLane]     = opParams.envelope;
+				lanes.squarepusher[iLane] = opParams.squarepusher;
+				lanes.index[iLane]        = opParams.index;
+				lanes.amplitude[iLane]    = opParams.amplitude;
+				lanes.feedbackAmt[iLane]  = opParams.feedbackAmt;
+				lanes.panning[iLane]      = opParams.panning;
+			}
+
+			// Get modulation from 3 sources (see Voice::Sample())
+			__m128 phaseShift = zero;
+			if (false == topOp.noModulation)
+			{
+				for (int iModulator : topOp.modulators)
+				{
+					const __m128 modSample = (-1 != iModulator) ? _mm_load_ps(m_operators[iModulator].modSample) : zero;
+					phaseShift = _mm_add_ps(phaseShift, _mm_add_ps(one, modSample));
+				}
+
+				phaseShift = _mm_max_ps(phaseShift, zero);
+			}
+
+			// Get feedback
+			if (-1 != topOp.iFeedback)
+				phaseShift = _mm_add_ps(phaseShift, _mm_load_ps(m_operators[topOp.iFeedback].feedback));
+
+			_mm_store_ps(lanes.phaseShift, phaseShift);
+
+			OscillateOperatorLanes(lanes, kVoiceLanes, modulation);
+			OutputOperatorLanes(lanes, kVoiceLanes, ampBend);
+
+			// Add samples to gain envelopes (for VU meter)
+			for (unsigned iLane = 0; iLane < m_numVoices; ++iLane)
+				m_voices[iLane]->m_operators[iOp].envGain.Apply(lanes.gain[iLane]);
+
+			// Mix (carriers only, the rest is zero)
+			mixL = _mm_add_ps(mixL, _mm_load_ps(lanes.outL));
+			mixR = _mm_add_ps(mixR, _mm_load_ps(lanes.outR));
+		}
+
+		alignas(16) float voiceL[kVoiceLanes], voiceR[kVoiceLanes];
+		_mm_store_ps(voiceL, mixL);
+		_mm_store_ps(voiceR, mixR);
+
+		// Apply global amp. & store result
+		for (unsigned iLane = 0; iLane < m_numVoices; ++iLane)
+		{
+			FloatAssert(voiceL[iLane]);
+			FloatAssert(voiceR[iLane]);
+
+			const float amplitude = m_voices[iLane]->m_globalAmp.Sample();
+			pLeft[iLane]  = voiceL[iLane]*amplitude;
+			pRight[iLane] = voiceR[iLane]*amplitude;
+		}
+	}
+
+#else
+
+	void VoiceLanes::Load(Voice * const *, unsigned)
+	{
+		SFM_ASSERT(false); // No voice is eligible
+	}
+
+	void VoiceLanes::Store()
+	{
+	}
+
+	void VoiceLanes::Sample(float *, float *, const float *, float, float, float, float)
+	{
+	}
+
+#endif
+}
@@ -0,0 +1,66 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Voices rendered in lockstep (voices in SIMD lanes).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	A group of up to kVoiceLanes voices that share topology (enabled operators, modulators, feedback & carriers)
+	is rendered side by side: each operator is processed for all voices at once by the operator kernel (see
+	synth-operator-kernel.h), using the voices as lanes. In polyphonic mode all voices are initialized from the
+	same patch, so dense chords and pads fill the lanes nicely.
+
+	- Hot operator state (phase, feedback & modulation) is mirrored in structure-of-arrays form for the duration
+	  of a block; call Load() before and Store() after rendering
+	- Envelopes & interpolated parameters are objects of their own and stay scalar (per voice)
+	- Only voices with nothing but plain (unfiltered) sines qualify (Voice::m_plainSines)
+	- Output is identical to rendering the voices one by one using Voice::Sample()
+*/
+
+#pragma once
+
+#include "synth-global.h"
+#include "synth-voice.h"
+#include "synth-operator-kernel.h"
+
+namespace SFM
+{
+	// Max. number of voices rendered in lockstep (SSE register width)
+	constexpr unsigned kVoiceLanes = 4;
+
+	class VoiceLanes
+	{
+	public:
+		// Can voice be rendered in lanes? (checked per block, since it can't be in the middle of a MIDI offset)
+		static bool IsEligible(const Voice &voice);
+
+		// Do (eligible) voices share topology?
+		static bool IsCompatible(const Voice &voiceA, const Voice &voiceB);
+
+		// Mirror hot state (voices must be eligible & compatible)
+		void Load(Voice * const *pVoices, unsigned numVoices);
+
+		// Write hot state back to voices
+		void Store();
+
+		// Render a single sample for each voice ('dry', like Voice::SampleWithBendMul()), 'pPitchBendMul' holds a multiplier per lane
+		void Sample(float *pLeft, float *pRight, const float *pPitchBendMul, float ampBend, float modulation, float LFOBlend, float LFOModDepth);
+
+		SFM_INLINE unsigned GetNumVoices() const
+		{
+			return m_numVoices;
+		}
+
+		SFM_INLINE Voice &GetVoice(unsigned iLane) const
+		{
+			SFM_ASSERT(iLane < m_numVoices);
+			return *m_voices[iLane];
+		}
+
+	private:
+		Voice *m_voices[kVoiceLanes] = { nullptr };
+		unsigned m_numVoices = 0;
+
+		// Per operator, voices in lanes
+		OperatorLanes m_operators[kNumOperators];
+	};
+}
@@ -7,6 +7,7 @@
 
 #include "synth-voice.h"
 #include "synth-distort.h"
+#include "synth-operator-kernel.h"
 
 namespace SFM
 {
@@ -40,6 +41,7 @@ namespace SFM
 		modulators[1] = -1;
 		modulators[2] = -1;
 		noModulation = true;
+		vectorize = false;
 
 		// No feedback input
 		iFeedback = -1;
@@ -99,6 +101,7 @@ namespace SFM
 		m_key = -1;
 		m_velocity = 0.f;
 		m_sampleOffs = 0;
+		m_opPatchGen = 0;
 
 		// Disable
 		m_state = kIdle;
@@ -117,7 +120,7 @@ namespace SFM
 		m_pitchEnvelope.Reset(sampleRate);
 
 		// Reset main filter
-		m_filterSVF.resetState();
+		m_filterSVF.Reset();
 
 		// Def. glide
 		m_freqGlide = kDefPolyFreqGlide;
@@ -125,6 +128,15 @@ namespace SFM
 		PostInitialize();
 	}
 
+	// Sine without operator or modulator filter
+	static bool IsPlainSine(const Voice::Operator &voiceOp)
+	{
+		return
+			Oscillator::Waveform::kSine == voiceOp.oscillator.GetWaveform() &&
+			bq_type_none == voiceOp.filter.getType() &&
+			SvfLinearTrapOptimised2::NO_FLT_TYPE == voiceOp.modFilter.getFilterType();
+	}
+
 	void Voice::PostInitialize()
 	{
 		// Clear modulation buffer
@@ -147,6 +159,84 @@ namespace SFM
 			}
 		}
 
+		// Set vectorization flags: plain (unfiltered) sines only
+		m_plainSines = true;
+
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			auto &voiceOp = m_operators[iOp];
+
+			if (false == voiceOp.enabled)
+			{
+				voiceOp.vectorize = false;
+				continue;
+			}
+
+			const bool plainSine = IsPlainSine(voiceOp);
+
+			// All of them for lanes (see synth-voice-lanes.h)
+			if (false == plainSine)
+				m_plainSines = false;
+
+			// Since the operator kernel's results are written back after all scalar operators are done, no operator
+			// processed later on may depend on it's output within the same sample
+			voiceOp.vectorize = plainSine;
+
+			for (unsigned iLater = iOp+1; iLater < kNumOperators && true == voiceOp.vectorize; ++iLater)
+			{
+				const auto &laterOp = m_operators[iLater];
+
+				if (int(iOp) == laterOp.iFeedback)
+					voiceOp.vectorize = false;
+
+				for (int iModulator : laterOp.modulators)
+				{
+					if (int(iOp) == iModulator)
+						voiceOp.vectorize = false;
+				}
+			}
+		}
+
+		// Can operators be rendered one by one, last to first?
+		m_blockRender = true;
+
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			const auto &voiceOp = m_operators[iOp];
+
+			if (true == voiceOp.enabled)
+			{
+				for (int iModulator : voiceOp.modulators)
+				{
+					if (-1 != iModulator && iModulator < int(iOp))
+						m_blockRender = false;
+				}
+
+				if (-1 != voiceOp.iFeedback && voiceOp.iFeedback < int(iOp))
+					m_blockRender = false;
+
+				// These draw from the (shared) random generator, which must happen in the same order as Sample() does
+				const Oscillator::Waveform form = voiceOp.oscillator.GetWaveform();
+				if (Oscillator::Waveform::kWhiteNoise == form || Oscillator::Waveform::kPinkNoise == form || Oscillator::Waveform::kSampleAndHold == form)
+					m_blockRender = false;
+			}
+		}
+
+		// Compile plan (last to first, see Render()), picking a kernel that fits each operator's topology
+		m_plan.numSteps = 0;
+
+		for (int iOp = kNumOperators-1; iOp >= 0; --iOp)
+		{
+			const auto &voiceOp = m_operators[iOp];
+
+			if (true == voiceOp.enabled)
+			{
+				RenderPlan::Step &step = m_plan.steps[m_plan.numSteps++];
+				step.iOp = iOp;
+				step.kernel = GetOperatorKernel(false == voiceOp.noModulation, -1 != voiceOp.iFeedback, voiceOp.isCarrier, IsPlainSine(voiceOp));
+			}
+		}
+
 		// Set global amplitude
 		m_globalAmp.Set(kVoiceGain);
 	}
@@ -220,7 +310,158 @@ namespace SFM
 	// Bright
 	constexpr float kFeedbackScale = 1.f;
 
+	Voice::VoiceModulation Voice::SampleModulation(float pitchBendMul, float LFOBlend, float LFOModDepth)
+	{
+		VoiceModulation voiceMod;
+
+		// Calculate LFO value
+		const float modLFO = m_modLFO.Sample(0.f);
+
+		auto modulate = [](float input, float modulation, float depth)
+		{
+			const float sample = input*modulation;
+			return lerpf<float>(input, sample, depth);
+		};
+
+		const float LFO1 = modulate(m_LFO1.Sample(0.f /* Do something funky here? */), modLFO, LFOModDepth);
+		const float LFO2 = modulate(m_LFO2.Sample(0.f), modLFO, LFOModDepth);
+		const float blend = lerpf<float>(LFO1, LFO2, LFOBlend);
+
+		voiceMod.LFO = blend;
+
+		SFM_ASSERT_BINORM(voiceMod.LFO);
+        
+		// Calc. pitch envelope multiplier (bend multiplier is supplied, see CalcPitchBendMul())
+		voiceMod.pitchRangeOct = m_pitchBendRange/12.f;
+		voiceMod.pitchEnv = powf(2.f, m_pitchEnvelope.Sample(false)*voiceMod.pitchRangeOct); // Sample pitch envelope (does not sustain!)
+		voiceMod.pitchBend = pitchBendMul;
+
+		return voiceMod;
+	}
+
+	Voice::OperatorParameters Voice::SampleOperator(Operator &voiceOp, const VoiceModulation &voiceMod, float modulation)
+	{
+		OperatorParameters opParams;
+
+		opParams.frequency = voiceOp.curFreq.Sample();
+		opParams.amplitude = voiceOp.amplitude.Sample();
+		opParams.index = voiceOp.index.Sample();
+		opParams.envelope = voiceOp.envelope.Sample();
+		opParams.squarepusher = voiceOp.softClip.Sample();
+		opParams.feedbackAmt = voiceOp.feedbackAmt.Sample() * kFeedbackScale;
+		const float curPanning = voiceOp.panning.Sample();
+
+		if (Oscillator::Waveform::kSupersaw == voiceOp.oscillator.GetWaveform())
+		{
+			// Special case
+			opParams.supersawDetune = voiceOp.supersawDetune.Sample();
+			opParams.supersawMix    = voiceOp.supersawMix.Sample();
+		}
+		else
+			opParams.supersawDetune = opParams.supersawMix = 0.f;
+
+		// Vibrato: pitch bend, pitch envelope & pitch LFO
+		const float pitchLFO = powf(2.f, voiceMod.LFO*voiceOp.pitchMod*modulation * voiceMod.pitchRangeOct);
+		opParams.vibrato = voiceMod.pitchBend*voiceMod.pitchEnv*pitchLFO;
+
+		// Calc. panning
+		const float panMod = voiceOp.panMod;
+		/* const */ float panning = (0.f == panMod)
+			? curPanning
+			: voiceMod.LFO*panMod*modulation*0.5f + 0.5f; // If panning modulation is set it overrides manual panning
+
+		// Because parameter interpolation is not very precise, and a negative square root is in that it is unforgiving
+		opParams.panning = Clamp(panning); 
+
+		return opParams;
+	}
+
+	/* static */ void Voice::SetOperatorPitch(Operator &voiceOp, const OperatorParameters &opParams)
+	{
+		auto &oscillator = voiceOp.oscillator;
+
+		// Set base freq.
+		if (Oscillator::Waveform::kSupersaw != oscillator.GetWaveform())
+			oscillator.SetFrequency(opParams.frequency);
+		else
+			oscillator.GetSupersaw().SetFrequency(opParams.frequency, opParams.supersawDetune, opParams.supersawMix);
+
+		// Apply vibrato
+		oscillator.PitchBend(opParams.vibrato);
+	}
+
+	/* static */ float Voice::SampleOperatorOutput(Operator &voiceOp, const OperatorParameters &opParams, float phaseShift, float LFO, float modulation, float ampBend, float &modSample)
+	{
+		// Calculate sample
+		float sample = voiceOp.oscillator.Sample(phaseShift);
+
+		// LFO tremolo
+		const float tremolo = 1.f - fabsf(LFO*voiceOp.ampMod);
+		sample = lerpf<float>(sample, sample*tremolo, modulation);
+
+		// Apply envelope
+		sample *= opParams.envelope;
+
+		// Apply "Squarepusher" distortion
+		if (0.f != opParams.squarepusher)
+		{
+			const float squared = Squarepusher(sample, opParams.squarepusher);
+			sample = lerpf<float>(sample, squared, opParams.squarepusher);
+		}
+
+#if !defined(SFM_DISABLE_FX)
+
+		// Apply filter
+		bool hasOpFilter = true;
+
+		switch (voiceOp.filter.getType())
+		{
+		case bq_type_none:
+			hasOpFilter = false;
+			break;
+
+		default:
+			// I'm assuming the filter is set up properly
+			voiceOp.filter.processMono(sample);
+		}
+
+#else
+
+		bool hasOpFilter = false;
+
+#endif
+
+		// Store (filtered) sample for modulation, with modulation index applied
+		modSample = sample*opParams.index;
+		
+		if (false == hasOpFilter && SvfLinearTrapOptimised2::NO_FLT_TYPE != voiceOp.modFilter.getFilterType())
+		{
+			// Only apply if modulator filter set (only applied to a few waveforms)
+			voiceOp.modFilter.tickMono(modSample);
+		}
+
+		// Apply (linear) amplitude to sample (including possible 'bend')
+		sample *= opParams.amplitude*ampBend;
+
+		// Add sample to gain envelope (for VU meter)
+		const float gainSample = (voiceOp.isCarrier)     // Carrier prioritized if both (FIXME?)
+			? sample                                     // Adj. for actual volume
+			: fabsf(modSample)/(kEpsilon+opParams.index); // Normalized (with a little hack that prevents a branch to check for zero, which in turn *might* push the value a teensy bit (kEpsilon) out of range)
+		voiceOp.envGain.Apply(gainSample);
+
+		// Update feedback
+		voiceOp.feedback = 0.25f*(voiceOp.feedback*0.995f + fabsf(sample)*opParams.feedbackAmt);
+
+		return sample;
+	}
+
 	void Voice::Sample(float &left, float &right, float pitchBend, float ampBend, float modulation, float LFOBlend, float LFOModDepth)
+	{
+		SFM_ASSERT_BINORM(pitchBend);
+		SampleWithBendMul(left, right, CalcPitchBendMul(pitchBend, m_pitchBendRange), ampBend, modulation, LFOBlend, LFOModDepth);
+	}
+
+	void Voice::SampleWithBendMul(float &left, float &right, float pitchBendMul, float ampBend, float modulation, float LFOBlend, float LFOModDepth)
 	{
 		// Render?
 		if (kIdle == m_state || m_sampleOffs > 0)
@@ -238,38 +479,30 @@ namespace SFM
 		
 		// Parameter assertions
 		SFM_ASSERT(ampBend >= dB2Lin(-kAmpBendRange) && ampBend <= dB2Lin(kAmpBendRange)); // Linear gain
-		SFM_ASSERT_BINORM(pitchBend);
+		SFM_ASSERT(pitchBendMul > 0.f);
 		SFM_ASSERT_NORM(modulation);
 		SFM_ASSERT_NORM(LFOBlend);
 		SFM_ASSERT(LFOModDepth >= 0.f);
 		
-		// Calculate LFO value
-		const float modLFO = m_modLFO.Sample(0.f);
-
-		auto modulate = [](float input, float modulation, float depth)
-		{
-			const float sample = input*modulation;
-			return lerpf<float>(input, sample, depth);
-		};
-
-		const float LFO1 = modulate(m_LFO1.Sample(0.f /* Do something funky here? */), modLFO, LFOModDepth);
-		const float LFO2 = modulate(m_LFO2.Sample(0.f), modLFO, LFOModDepth);
-		const float blend = lerpf<float>(LFO1, LFO2, LFOBlend);
-
-		const float LFO = blend;
-
-		SFM_ASSERT_BINORM(LFO);
-        
-		// Calc. pitch envelope & bend multipliers
-		const float pitchRangeOct = m_pitchBendRange/12.f;
-		const float pitchEnv = powf(2.f, m_pitchEnvelope.Sample(false)*pitchRangeOct); // Sample pitch envelope (does not sustain!)
-		pitchBend = powf(2.f, pitchBend*pitchRangeOct);
+		// LFO, pitch envelope & bend
+		const VoiceModulation voiceMod = SampleModulation(pitchBendMul, LFOBlend, LFOModDepth);
+		const float LFO = voiceMod.LFO;
 
 		//
 		// Process all operators
 		//
         
-		float mixL = 0.f, mixR = 0.f; // Carrier mix
+		// Carrier output per operator, mixed in order at the end so the result does not depend on which path an operator took
+		float opMixL[kNumOperators] = { 0.f }, opMixR[kNumOperators] = { 0.f };
+
+#if defined(SFM_SIMD_OPERATORS)
+
+		// Operators processed by the vectorized kernel
+		OperatorLanes lanes;
+		int laneOps[kOperatorLanes];
+		unsigned numLanes = 0;
+
+#endif
 
 		for (int iOp = 0; iOp < kNumOperators; ++iOp)
 		{
@@ -277,29 +510,11 @@ namespace SFM
 
 			if (true == voiceOp.enabled)
 			{
-				const float curFreq = voiceOp.curFreq.Sample();
-				const float curAmplitude = voiceOp.amplitude.Sample();
-				const float curIndex = voiceOp.index.Sample();
-				const float curEG = voiceOp.envelope.Sample();
-				const float curSquarepusher = voiceOp.softClip.Sample();
-				const float curFeedbackAmt = voiceOp.feedbackAmt.Sample() * kFeedbackScale;
-				const float curPanning = voiceOp.panning.Sample();
-				
-				// Set base freq.
-				auto &oscillator = voiceOp.oscillator;
+				// Parameters, frequency & vibrato
+				const OperatorParameters opParams = SampleOperator(voiceOp, voiceMod, modulation);
+				SetOperatorPitch(voiceOp, opParams);
 
-				if (Oscillator::Waveform::kSupersaw != oscillator.GetWaveform())
-				{
-					oscillator.SetFrequency(curFreq);
-				}
-				else
-				{
-					// Special case
-					const float curDetune = voiceOp.supersawDetune.Sample();
-					const float curMix    = voiceOp.supersawMix.Sample();
-					
-					oscillator.GetSupersaw().SetFrequency(curFreq, curDetune, curMix);
-				}
+				auto &oscillator = voiceOp.oscillator;
 
 				// Get modulation from 3 sources
 				float phaseShift = 0.f;
@@ -331,101 +546,373 @@ namespace SFM
 					SFM_ASSERT(feedback >= 0.f);
 				}
 
-				// Vibrato: pitch bend, pitch envelope & pitch LFO
-				const float pitchLFO = powf(2.f, LFO*voiceOp.pitchMod*modulation * pitchRangeOct);
-				const float vibrato = pitchBend*pitchEnv*pitchLFO;
-				oscillator.PitchBend(vibrato);
+#if defined(SFM_SIMD_OPERATORS)
 
-				// Calculate sample
-				float sample = oscillator.Sample(phaseShift+feedback);
+				if (true == voiceOp.vectorize)
+				{
+					SFM_ASSERT(numLanes < kNumOperators);
+
+					const unsigned iLane = numLanes++;
+					laneOps[iLane] = iOp;
+
+					const Phase &phase = oscillator.GetPhaseObject();
+					lanes.phase[iLane]        = phase.Get();
+					lanes.pitch[iLane]        = phase.GetPitch();
+					lanes.phaseShift[iLane]   = phaseShift+feedback;
+					lanes.tremolo[iLane]      = LFO*voiceOp.ampMod;
+					lanes.envelope[iLane]     = opParams.envelope;
+					lanes.squarepusher[iLane] = opParams.squarepusher;
+					lanes.index[iLane]        = opParams.index;
+					lanes.amplitude[iLane]    = opParams.amplitude;
+					lanes.feedback[iLane]     = voiceOp.feedback;
+					lanes.feedbackAmt[iLane]  = opParams.feedbackAmt;
+					lanes.panning[iLane]      = opParams.panning;
+					lanes.carrier[iLane]      = (true == voiceOp.isCarrier) ? -1 : 0;
+
+					continue;
+				}
 
-				// LFO tremolo
-				const float tremolo = 1.f - fabsf(LFO*voiceOp.ampMod);
-				sample = lerpf<float>(sample, sample*tremolo, modulation);
+#endif
 
-				// Apply envelope
-				sample *= curEG;
+				// Calculate sample
+				float modSample;
+				const float sample = SampleOperatorOutput(voiceOp, opParams, phaseShift+feedback, LFO, modulation, ampBend, modSample);
+				m_modSamples[iOp+1] = modSample;
 
-				// Apply "Squarepusher" distortion
-				if (0.f != curSquarepusher)
+				if (true == voiceOp.isCarrier)
 				{
-					const float squared = Squarepusher(sample, curSquarepusher);
-					sample = lerpf<float>(sample, squared, curSquarepusher);
+					const float carrierL = sample*sqrtf(1.f-opParams.panning);
+					const float carrierR = sample*sqrtf(opParams.panning);
+					
+					// We've had some trouble here (see SampleOperator(), negative square root...)
+					FloatAssert(carrierL);
+					FloatAssert(carrierR);
+
+					// Apply panning (square law panning retains equal power)
+					opMixL[iOp] = carrierL;
+					opMixR[iOp] = carrierR;
 				}
+			}
+		}
 
-#if !defined(SFM_DISABLE_FX)
+#if defined(SFM_SIMD_OPERATORS)
 
-				// Apply filter
-				bool hasOpFilter = true;
+		if (numLanes > 0)
+		{
+			const unsigned numPadded = PadOperatorLanes(lanes, numLanes);
 
-				switch (voiceOp.filter.getType())
-				{
-				case bq_type_none:
-					hasOpFilter = false;
-					break;
+			OscillateOperatorLanes(lanes, numPadded, modulation);
+			OutputOperatorLanes(lanes, numPadded, ampBend);
 
-				default:
-					// I'm assuming the filter is set up properly
-					voiceOp.filter.processMono(sample);
-				}
+			// Write back
+			for (unsigned iLane = 0; iLane < numLanes; ++iLane)
+			{
+				const int iOp = laneOps[iLane];
+				Operator &voiceOp = m_operators[iOp];
 
-#else
+				voiceOp.oscillator.GetPhaseObject().Set(lanes.phase[iLane]);
+				m_modSamples[iOp+1] = lanes.modSample[iLane];
+				voiceOp.envGain.Apply(lanes.gain[iLane]);
+				voiceOp.feedback = lanes.feedback[iLane];
 
-				bool hasOpFilter = false;
+				FloatAssert(lanes.outL[iLane]);
+				FloatAssert(lanes.outR[iLane]);
+
+				opMixL[iOp] = lanes.outL[iLane];
+				opMixR[iOp] = lanes.outR[iLane];
+			}
+		}
 
 #endif
 
-				// Store (filtered) sample for modulation, with modulation index applied
-				float modSample = sample*curIndex;
-				
-				if (false == hasOpFilter && SvfLinearTrapOptimised2::NO_FLT_TYPE != voiceOp.modFilter.getFilterType())
+		// Mix carriers
+		float mixL = 0.f, mixR = 0.f;
+
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			mixL += opMixL[iOp];
+			mixR += opMixR[iOp];
+		}
+
+		// Apply global amp. & store result
+		const float amplitude = m_globalAmp.Sample();
+		left  = mixL*amplitude;
+		right = mixR*amplitude;
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Operator kernels (block), specialized by topology; same as the operator part of Sample()
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	template<bool kModulated, bool kFeedback, bool kCarrier, bool kPlainSine>
+	/* static */ void Voice::RenderOperatorBlock(Operator &voiceOp, const OperatorBlock &block)
+	{
+		SFM_ASSERT(kModulated == (false == voiceOp.noModulation));
+		SFM_ASSERT(kFeedback == (nullptr != block.pFeedbackIn));
+		SFM_ASSERT(kCarrier == voiceOp.isCarrier);
+
+		for (unsigned iSample = 0; iSample < block.numSamples; ++iSample)
+		{
+			const OperatorParameters &opParams = block.pParams[iSample];
+
+			// Get modulation from 3 sources (see Sample())
+			float phaseShift = 0.f;
+			if (true == kModulated)
+			{
+				phaseShift += 1.f+block.pModIn[0][iSample];
+				phaseShift += 1.f+block.pModIn[1][iSample];
+				phaseShift += 1.f+block.pModIn[2][iSample];
+
+				phaseShift = std::max<float>(0.f, phaseShift);
+			}
+
+			if (true == kFeedback)
+			{
+				SFM_ASSERT(block.pFeedbackIn[iSample] >= 0.f);
+				phaseShift += block.pFeedbackIn[iSample];
+			}
+
+			const float LFO = block.pVoiceMods[iSample].LFO;
+			const float modulation = block.pModulation[iSample];
+
+			float sample, modSample;
+
+			if (false == kPlainSine)
+			{
+				SetOperatorPitch(voiceOp, opParams);
+				sample = SampleOperatorOutput(voiceOp, opParams, phaseShift, LFO, modulation, block.pAmpBend[iSample], modSample);
+			}
+			else
+			{
+				// Sine, no filters (so the Oscillator::Sample() switch and SampleOperatorOutput() filter checks are skipped)
+				Phase &phaseObj = voiceOp.oscillator.GetPhaseObject();
+				phaseObj.SetFrequency(opParams.frequency);
+				phaseObj.PitchBend(opParams.vibrato);
+
+				const float phase = phaseObj.Sample();
+				const float modulated = (true == kModulated || true == kFeedback)
+					? ((0.f == phaseShift) ? phase : fmodf(phase+phaseShift, 1.f))
+					: phase;
+
+				sample = oscSine(modulated);
+
+				// LFO tremolo
+				const float tremolo = 1.f - fabsf(LFO*voiceOp.ampMod);
+				sample = lerpf<float>(sample, sample*tremolo, modulation);
+
+				// Apply envelope
+				sample *= opParams.envelope;
+
+				// Apply "Squarepusher" distortion
+				if (0.f != opParams.squarepusher)
 				{
-					// Only apply if modulator filter set (only applied to a few waveforms)
-					voiceOp.modFilter.tickMono(modSample);
+					const float squared = Squarepusher(sample, opParams.squarepusher);
+					sample = lerpf<float>(sample, squared, opParams.squarepusher);
 				}
-				
-				m_modSamples[iOp+1] = modSample;
+
+				// Store sample for modulation, with modulation index applied
+				modSample = sample*opParams.index;
 
 				// Apply (linear) amplitude to sample (including possible 'bend')
-				sample *= curAmplitude*ampBend;
+				sample *= opParams.amplitude*block.pAmpBend[iSample];
 
 				// Add sample to gain envelope (for VU meter)
-				const float gainSample = (voiceOp.isCarrier)   // Carrier prioritized if both (FIXME?)
-					? sample                                   // Adj. for actual volume
-					: fabsf(modSample)/(kEpsilon+curIndex);    // Normalized (with a little hack that prevents a branch to check for zero, which in turn *might* push the value a teensy bit (kEpsilon) out of range)
+				const float gainSample = (true == kCarrier)
+					? sample
+					: fabsf(modSample)/(kEpsilon+opParams.index);
 				voiceOp.envGain.Apply(gainSample);
 
 				// Update feedback
-				voiceOp.feedback = 0.25f*(voiceOp.feedback*0.995f + fabsf(sample)*curFeedbackAmt);
-								
-				if (true == voiceOp.isCarrier)
-				{
-					// Calc. panning
-					const float panMod = voiceOp.panMod;
-					/* const */ float panning = (0.f == panMod)
-						? curPanning
-						: LFO*panMod*modulation*0.5f + 0.5f; // If panning modulation is set it overrides manual panning
+				voiceOp.feedback = 0.25f*(voiceOp.feedback*0.995f + fabsf(sample)*opParams.feedbackAmt);
+			}
 
-					// Because parameter interpolation is not very precise, and a negative square root is in that it is unforgiving
-					panning = Clamp(panning); 
+			block.pModOut[iSample] = modSample;
+			block.pFeedbackOut[iSample] = voiceOp.feedback;
+
+			if (true == kCarrier)
+			{
+				block.pCarrier[iSample] = sample;
+				block.pPanning[iSample] = opParams.panning;
+			}
+		}
+	}
+
+	/* static */ Voice::OperatorKernel Voice::GetOperatorKernel(bool modulated, bool feedback, bool carrier, bool plainSine)
+	{
+		// Indexed by [modulated][feedback][carrier][plainSine]
+		static const OperatorKernel kKernels[2][2][2][2] =
+		{
+			{ 
+				{ { RenderOperatorBlock<false, false, false, false>, RenderOperatorBlock<false, false, false, true> },
+				  { RenderOperatorBlock<false, false, true,  false>, RenderOperatorBlock<false, false, true,  true> } },
+				{ { RenderOperatorBlock<false, true,  false, false>, RenderOperatorBlock<false, true,  false, true> },
+				  { RenderOperatorBlock<false, true,  true,  false>, RenderOperatorBlock<false, true,  true,  true> } }
+			},
+			{
+				{ { RenderOperatorBlock<true,  false, false, false>, RenderOperatorBlock<true,  false, false, true> },
+				  { RenderOperatorBlock<true,  false, true,  false>, RenderOperatorBlock<true,  false, true,  true> } },
+				{ { RenderOperatorBlock<true,  true,  false, false>, RenderOperatorBlock<true,  true,  false, true> },
+				  { RenderOperatorBlock<true,  true,  true,  false>, RenderOperatorBlock<true,  true,  true,  true> } }
+			}
+		};
+
+		return kKernels[modulated][feedback][carrier][plainSine];
+	}
+
+	/* ----------------------------------------------------------------------------------------------------
+
+		Block render; same as calling Sample() for each sample, but in stages
+
+	 ------------------------------------------------------------------------------------------------------ */
+
+	void Voice::Render(unsigned numSamples, const float *pPitchBendMul, const float *pAmpBend, const float *pModulation, const float *pLFOBlend, const float *pLFOModDepth, float *pLeft, float *pRight)
+	{
+		SFM_ASSERT(numSamples <= kVoiceBlockSize);
+		SFM_ASSERT(nullptr != pPitchBendMul && nullptr != pAmpBend && nullptr != pModulation && nullptr != pLFOBlend && nullptr != pLFOModDepth);
+		SFM_ASSERT(nullptr != pLeft && nullptr != pRight);
+
+		if (false == m_blockRender)
+		{
+			// Topology or waveforms don't allow it (see PostInitialize())
+			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+				SampleWithBendMul(pLeft[iSample], pRight[iSample], pPitchBendMul[iSample], pAmpBend[iSample], pModulation[iSample], pLFOBlend[iSample], pLFOModDepth[iSample]);
+
+			return;
+		}
+
+		SFM_ASSERT(kIdle != m_state); // Idle voices shouldn't be rendered
+
+		// MIDI sync.
+		const unsigned offset = std::min<unsigned>(m_sampleOffs, numSamples);
+		m_sampleOffs -= offset;
+
+		for (unsigned iSample = 0; iSample < offset; ++iSample)
+			pLeft[iSample] = pRight[iSample] = 0.f;
+
+		numSamples -= offset;
+
+		if (0 == numSamples)
+			return;
+
+		pPitchBendMul += offset;
+		pAmpBend     += offset;
+		pModulation  += offset;
+		pLFOBlend    += offset;
+		pLFOModDepth += offset;
+		pLeft        += offset;
+		pRight       += offset;
+
+		//
+		// Stage 1: LFO, pitch envelope & bend
+		//
+
+		VoiceModulation voiceMods[kVoiceBlockSize];
+
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+			voiceMods[iSample] = SampleModulation(pPitchBendMul[iSample], pLFOBlend[iSample], pLFOModDepth[iSample]);
+
+		//
+		// Stage 2: operators, last to first (so modulation & feedback of the previous sample is available)
+		//
+
+		// Modulation & feedback, the first slot holding the previous sample (mirrors m_modSamples & Operator::feedback)
+		alignas(16) float modSamples[kNumOperators+1][kVoiceBlockSize+1]; // First row for index -1
+		alignas(16) float feedback[kNumOperators][kVoiceBlockSize+1];
+
+		// Carrier output (amplitude applied) & panning
+		alignas(16) float carriers[kNumOperators][kVoiceBlockSize];
+		alignas(16) float panning[kNumOperators][kVoiceBlockSize];
+
+		for (unsigned iSample = 0; iSample <= numSamples; ++iSample)
+			modSamples[0][iSample] = m_modSamples[0];
+
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			const Operator &voiceOp = m_operators[iOp];
+
+			// Disabled operators hold on to their last values
+			const unsigned numHeld = (true == voiceOp.enabled) ? 1 : numSamples+1;
+
+			for (unsigned iSample = 0; iSample < numHeld; ++iSample)
+			{
+				modSamples[iOp+1][iSample] = m_modSamples[iOp+1];
+				feedback[iOp][iSample] = voiceOp.feedback;
+			}
+		}
+
+		// Follow plan
+		for (unsigned iStep = 0; iStep < m_plan.numSteps; ++iStep)
+		{
+			const RenderPlan::Step &step = m_plan.steps[iStep];
+
+			const int iOp = step.iOp;
+			Operator &voiceOp = m_operators[iOp];
+
+			// Parameters (interpolated), envelope & vibrato
+			OperatorParameters opParams[kVoiceBlockSize];
+
+			for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+				opParams[iSample] = SampleOperator(voiceOp, voiceMods[iSample], pModulation[iSample]);
+
+			// Oscillator, with modulation & feedback
+			OperatorBlock block;
+			block.numSamples   = numSamples;
+			block.pParams      = opParams;
+			block.pVoiceMods   = voiceMods;
+			block.pModulation  = pModulation;
+			block.pAmpBend     = pAmpBend;
+			block.pModIn[0]    = modSamples[voiceOp.modulators[0]+1];
+			block.pModIn[1]    = modSamples[voiceOp.modulators[1]+1];
+			block.pModIn[2]    = modSamples[voiceOp.modulators[2]+1];
+			block.pFeedbackIn  = (-1 != voiceOp.iFeedback) ? feedback[voiceOp.iFeedback] : nullptr;
+			block.pModOut      = modSamples[iOp+1]+1;
+			block.pFeedbackOut = feedback[iOp]+1;
+			block.pCarrier     = carriers[iOp];
+			block.pPanning     = panning[iOp];
+
+			step.kernel(voiceOp, block);
+
+			m_modSamples[iOp+1] = block.pModOut[numSamples-1];
+		}
+
+		//
+		// Stage 3: pan & mix carriers (in order, like Sample())
+		//
+
+		alignas(16) float mixL[kVoiceBlockSize] = { 0.f }, mixR[kVoiceBlockSize] = { 0.f };
+
+		for (unsigned iOp = 0; iOp < kNumOperators; ++iOp)
+		{
+			const Operator &voiceOp = m_operators[iOp];
+
+			if (true == voiceOp.enabled && true == voiceOp.isCarrier)
+			{
+				const float *pCarrier = carriers[iOp];
+				const float *pPanning = panning[iOp];
+
+				for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+				{
+					// Square law panning
+					const float carrierL = pCarrier[iSample]*sqrtf(1.f-pPanning[iSample]);
+					const float carrierR = pCarrier[iSample]*sqrtf(pPanning[iSample]);
 
-					const float carrierL = sample*sqrtf(1.f-panning);
-					const float carrierR = sample*sqrtf(panning);
-					
-					// We've had some trouble here (see above, negative square root...)
 					FloatAssert(carrierL);
 					FloatAssert(carrierR);
 
-					// Apply panning & mix (square law panning retains equal power)
-					mixL += carrierL;
-					mixR += carrierR;
+					mixL[iSample] += carrierL;
+					mixR[iSample] += carrierR;
 				}
 			}
 		}
-		
+
 		// Apply global amp. & store result
-		const float amplitude = m_globalAmp.Sample();
-		left  = mixL*amplitude;
-		right = mixR*amplitude;
+		for (unsigned iSample = 0; iSample < numSamples; ++iSample)
+		{
+			const float amplitude = m_globalAmp.Sample();
+			pLeft[iSample]  = mixL[iSample]*amplitude;
+			pRight[iSample] = mixR[iSample]*amplitude;
+		}
 	}
 }
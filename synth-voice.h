@@ -21,9 +21,19 @@
 #include "synth-envelope.h"
 #include "synth-one-pole-filters.h"
 #include "synth-signal-follower.h"
+#include "synth-control-rate-SVF.h"
 
 namespace SFM
 {
+	// Max. number of samples Voice::Render() takes at once (scratch buffers live on the stack)
+	constexpr unsigned kVoiceBlockSize = 64;
+
+	// Pitch bend ([-1..1]) to frequency multiplier for a bend range (in semitones, see Voice::m_pitchBendRange)
+	SFM_INLINE float CalcPitchBendMul(float pitchBend, int pitchBendRange)
+	{
+		return powf(2.f, pitchBend*(pitchBendRange/12.f));
+	}
+
 	class Voice
 	{
 	public:
@@ -39,6 +49,9 @@ namespace SFM
 		// Fundamental frequency
 		float m_fundamentalFreq;
 
+		// Patch operators generation real-time parameters were last set from (see Bison::UpdateVoicesPreRender()), zero forces an update
+		unsigned m_opPatchGen;
+
 		enum State
 		{
 			kIdle      = 0, // Silent / Available
@@ -80,6 +93,7 @@ namespace SFM
 			// Yes, this means there is 1 frame of delay, but @ 44.1kHz that amounts to: 2,2675736961451247165532879818594e-5 and that value only gets smaller;
 			int modulators[3], iFeedback;
 			bool noModulation; // Small optimization (see Voice::Render()), initialized by PostInitialize()
+			bool vectorize;    // Processed by the vectorized kernel (see synth-operator-kernel.h), initialized by PostInitialize()
 
 			// Feedback (R)
 			// See: https://www.reddit.com/r/FMsynthesis/comments/85jfrb/dx7_feedback_implementation/
@@ -117,7 +131,7 @@ namespace SFM
 		Oscillator m_modLFO;
 
 		// Main filter (used in FM_BISON.cpp)
-		SvfLinearTrapOptimised2 m_filterSVF;
+		ControlRateSVF m_filterSVF;
 		
 		// Filter (amplitude) envelope
 		Envelope m_filterEnvelope;
@@ -132,9 +146,85 @@ namespace SFM
 		// Global amplitude
 		InterpolatedParameter<kLinInterpolate, true> m_globalAmp;
 
+		// All enabled operators are plain (unfiltered) sines, so the voice can be rendered in lanes (see synth-voice-lanes.h); initialized by PostInitialize()
+		bool m_plainSines;
+
+		// Operators only take modulation & feedback from themselves or higher operators (and none of them is noise or S&H), so they
+		// can be rendered one by one following a plan (see Render()); initialized by PostInitialize()
+		bool m_blockRender;
+
 	private:
 		void ResetOperators(unsigned sampleRate);
 
+		friend class VoiceLanes;
+
+		// Voice-wide modulation for a single sample
+		struct VoiceModulation
+		{
+			float LFO;
+			float pitchRangeOct;
+			float pitchEnv;  // Multiplier
+			float pitchBend; // Multiplier
+		};
+
+		// Operator parameters for a single sample
+		struct OperatorParameters
+		{
+			float frequency;
+			float vibrato; // Multiplier
+			float supersawDetune, supersawMix;
+			float amplitude;
+			float index;
+			float envelope;
+			float squarepusher;
+			float feedbackAmt;
+			float panning; // Clamped, final
+		};
+
+		// Shared by Sample(), Render() & VoiceLanes::Sample()
+		VoiceModulation SampleModulation(float pitchBendMul, float LFOBlend, float LFOModDepth);
+		OperatorParameters SampleOperator(Operator &voiceOp, const VoiceModulation &voiceMod, float modulation);
+		static void SetOperatorPitch(Operator &voiceOp, const OperatorParameters &opParams); // Call right before sampling the oscillator
+
+		// Scalar operator render: returns sample (amplitude applied), modulation sample & updates feedback
+		static float SampleOperatorOutput(Operator &voiceOp, const OperatorParameters &opParams, float phaseShift, float LFO, float modulation, float ampBend, float &modSample);
+
+		// A block of samples for a single operator (see Render())
+		struct OperatorBlock
+		{
+			unsigned numSamples;
+			const OperatorParameters *pParams;
+			const VoiceModulation *pVoiceMods;
+			const float *pModulation;
+			const float *pAmpBend;
+			const float *pModIn[3];   // Modulators (first slot is the previous sample)
+			const float *pFeedbackIn; // Feedback source (first slot is the previous sample), can be nullptr
+			float *pModOut;
+			float *pFeedbackOut;
+			float *pCarrier;
+			float *pPanning;
+		};
+
+		// Operator kernels, specialized by topology (see RenderOperatorBlock() and PostInitialize())
+		typedef void (*OperatorKernel)(Operator &voiceOp, const OperatorBlock &block);
+
+		template<bool kModulated, bool kFeedback, bool kCarrier, bool kPlainSine>
+		static void RenderOperatorBlock(Operator &voiceOp, const OperatorBlock &block);
+
+		static OperatorKernel GetOperatorKernel(bool modulated, bool feedback, bool carrier, bool plainSine);
+
+		// Execution plan for Render(): operators in order, each with it's kernel; compiled by PostInitialize()
+		struct RenderPlan
+		{
+			struct Step
+			{
+				int iOp;
+				OperatorKernel kernel;
+			} steps[kNumOperators];
+
+			unsigned numSteps;
+		} m_plan;
+
 	public:
 		void Reset(unsigned sampleRate);
 		
@@ -158,5 +248,12 @@ namespace SFM
 
 		// Render "dry" FM voice (see impl. for param. ranges)
 		void Sample(float &left, float &right, float pitchBend, float ampBend /* Linear gain */, float modulation, float LFOBias, float LFOModDepth);
+
+		// Same, but takes pitch bend as multiplier for this voice's range (see CalcPitchBendMul())
+		void SampleWithBendMul(float &left, float &right, float pitchBendMul, float ampBend /* Linear gain */, float modulation, float LFOBias, float LFOModDepth);
+
+		// Render "dry" FM voice, up to kVoiceBlockSize samples, in stages (parameters per sample, identical output to calling SampleWithBendMul())
+		// Falls back to SampleWithBendMul() if the topology or waveforms don't allow it (see m_blockRender)
+		void Render(unsigned numSamples, const float *pPitchBendMul, const float *pAmpBend, const float *pModulation, const float *pLFOBlend, const float *pLFOModDepth, float *pLeft, float *pRight);
 	};
 }
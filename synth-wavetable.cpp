@@ -0,0 +1,170 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Mip-mapped band-limited wavetables (alternative to PolyBLEP).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+*/
+
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+#include "synth-wavetable.h"
+
+namespace SFM
+{
+	// Number of points the naive waveforms are sampled at to get their harmonics; at this size the aliasing
+	// of the discontinuities is well below what ends up in a table
+	constexpr unsigned kAnalysisLog2Size = 15;
+	constexpr unsigned kAnalysisSize = 1 << kAnalysisLog2Size;
+
+	alignas(16) float g_wavetables[kNumWavetableForms][kWavetableNumLevels][kWavetableSize+2];
+
+	// In-place radix-2 FFT (not normalized), 'sign' is -1 for forward and 1 for inverse
+	static void FFT(std::complex<double> *bins, unsigned log2Size, double sign)
+	{
+		const unsigned size = 1 << log2Size;
+
+		// Bit reversal
+		for (unsigned iBin = 1, iReversed = 0; iBin < size; ++iBin)
+		{
+			unsigned bit = size >> 1;
+			for (; iReversed & bit; bit >>= 1)
+				iReversed ^= bit;
+
+			iReversed ^= bit;
+
+			if (iBin < iReversed)
+				std::swap(bins[iBin], bins[iReversed]);
+		}
+
+		// Butterflies
+		for (unsigned length = 2; length <= size; length <<= 1)
+		{
+			const double angle = sign*2.0*double(kPI)/length;
+			const std::complex<double> step(cos(angle), sin(angle));
+
+			for (unsigned iStart = 0; iStart < size; iStart += length)
+			{
+				std::complex<double> twiddle(1.0, 0.0);
+				for (unsigned iBin = 0; iBin < length/2; ++iBin)
+				{
+					const std::complex<double> even = bins[iStart+iBin];
+					const std::complex<double> odd  = bins[iStart+iBin+length/2]*twiddle;
+					bins[iStart+iBin] = even+odd;
+					bins[iStart+iBin+length/2] = even-odd;
+					twiddle *= step;
+				}
+			}
+		}
+	}
+
+	// Naive waveforms, the same as the oscPoly...() ones minus their BLEP/BLAMP correction
+	static double NaiveWaveform(WavetableForm form, double phase)
+	{
+		phase -= floor(phase);
+
+		switch (form)
+		{
+		case kWavetableTriangle:
+			{
+				double triangle = phase*4.0;
+				if (triangle >= 3.0)
+					triangle -= 4.0;
+				else if (triangle > 1.0)
+					triangle = 2.0 - triangle;
+
+				return triangle;
+			}
+
+		case kWavetableSquare:
+			return (phase < 0.5) ? 1.0 : -1.0;
+
+		case kWavetableSaw:
+			{
+				const double P1 = fmod(phase + 0.5, 1.0);
+				return 2.0*P1 - 1.0;
+			}
+
+		case kWavetableRamp:
+			return 1.0 - 2.0*phase;
+
+		case kWavetableRectifiedSine:
+			{
+				const double P1 = fmod(phase + 0.25, 1.0);
+				return 2.0*sin(double(kPI)*P1) - 2.0;
+			}
+
+		case kWavetableRectangle:
+			{
+				constexpr double width = 0.25;
+				return (phase < width) ? 2.0 - 2.0*width : -2.0*width;
+			}
+
+		default:
+			SFM_ASSERT(false);
+			return 0.0;
+		}
+	}
+
+	// Normalized sinc: sin(PI*x)/(PI*x)
+	static double Sinc(double x)
+	{
+		const double angle = double(kPI)*x;
+		return (0.0 != angle) ? sin(angle)/angle : 1.0;
+	}
+
+	void InitializeWavetables()
+	{
+		std::vector<std::complex<double>> harmonics(kAnalysisSize);
+		std::vector<std::complex<double>> table(kWavetableSize);
+
+		for (unsigned iForm = 0; iForm < kNumWavetableForms; ++iForm)
+		{
+			const WavetableForm form = WavetableForm(iForm);
+
+			// Sample naive waveform, the average of both sides where it's discontinuous
+			for (unsigned iPoint = 0; iPoint < kAnalysisSize; ++iPoint)
+			{
+				constexpr double side = 1e-9;
+				const double phase = double(iPoint)/kAnalysisSize;
+				harmonics[iPoint] = 0.5*(NaiveWaveform(form, phase-side) + NaiveWaveform(form, phase+side));
+			}
+
+			// Analyze
+			FFT(harmonics.data(), kAnalysisLog2Size, -1.0);
+
+			// Synthesize each level from DC up to it's number of harmonics
+			for (unsigned iLevel = 0; iLevel < kWavetableNumLevels; ++iLevel)
+			{
+				const unsigned numHarmonics = kWavetableMaxHarmonics >> iLevel;
+
+				// Lanczos sigma factors tame the Gibbs phenomenon (overshoot of about 9% at discontinuities, down to about 2.5%);
+				// they're normalized to the fundamental, which is left untouched so that loudness (and modulation index) don't
+				// drop in the levels that hold only a few harmonics
+				const double sigma1 = Sinc(1.0/(numHarmonics+1));
+
+				std::fill(table.begin(), table.end(), 0.0);
+
+				table[0] = harmonics[0]/double(kAnalysisSize);
+				for (unsigned iHarmonic = 1; iHarmonic <= numHarmonics; ++iHarmonic)
+				{
+					const double sigma = Sinc(double(iHarmonic)/(numHarmonics+1))/sigma1;
+
+					const std::complex<double> coefficient = sigma*harmonics[iHarmonic]/double(kAnalysisSize);
+					table[iHarmonic] = coefficient;
+					table[kWavetableSize-iHarmonic] = std::conj(coefficient);
+				}
+
+				FFT(table.data(), kWavetableLog2Size, 1.0);
+
+				float *pTable = g_wavetables[iForm][iLevel];
+				for (unsigned iSample = 0; iSample < kWavetableSize; ++iSample)
+					pTable[iSample] = float(table[iSample].real());
+
+				pTable[kWavetableSize]   = pTable[0];
+				pTable[kWavetableSize+1] = pTable[1];
+			}
+		}
+	}
+}
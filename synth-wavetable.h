@@ -0,0 +1,80 @@
+
+/*
+	FM. BISON hybrid FM synthesis -- Mip-mapped band-limited wavetables (alternative to PolyBLEP).
+	(C) njdewit technologies (visualizers.nl) & bipolaraudio.nl
+	MIT license applies, please see https://en.wikipedia.org/wiki/MIT_License or LICENSE in the project root!
+
+	- Tables are calculated once (see Bison()) and shared by all instances; they only depend on pitch, not on sample rate
+	- Each level holds half the harmonics of the previous one, so the level is picked by pitch (octave) such that
+	  the highest harmonic stays below Nyquist; the first level holds kWavetableMaxHarmonics, so notes below
+	  about 43Hz (at 44.1KHz) lose a bit of top end
+	- The waveforms are the same (phase, DC & all) as their oscPoly...() counterparts in synth-stateless-oscillators.h,
+	  Oscillator uses them instead if Oscillator::kWavetable is selected as engine
+*/
+
+#pragma once
+
+#include "synth-global.h"
+
+namespace SFM
+{
+	enum WavetableForm
+	{
+		kWavetableTriangle,
+		kWavetableSquare,
+		kWavetableSaw,
+		kWavetableRamp,
+		kWavetableRectifiedSine,
+		kWavetableRectangle, // Duty cycle 0.25
+		kNumWavetableForms
+	};
+
+	constexpr unsigned kWavetableLog2Size = 11; // Equals size of 2048
+	constexpr unsigned kWavetableSize = 1 << kWavetableLog2Size;
+
+	// Harmonics in the first level, the last one is a pure sine
+	constexpr unsigned kWavetableMaxHarmonics = 512;
+	constexpr unsigned kWavetableNumLevels = 10;
+
+	static_assert(kWavetableMaxHarmonics < kWavetableSize/2);
+	static_assert(1 == (kWavetableMaxHarmonics >> (kWavetableNumLevels-1)));
+
+	// Tables plus 2 samples each that wrap around (see oscWavetable())
+	extern float g_wavetables[kNumWavetableForms][kWavetableNumLevels][kWavetableSize+2];
+
+	void InitializeWavetables();
+
+	SFM_INLINE static const float *GetWavetable(WavetableForm form, unsigned level)
+	{
+		SFM_ASSERT(form < kNumWavetableForms);
+		SFM_ASSERT(level < kWavetableNumLevels);
+
+		return g_wavetables[form][level];
+	}
+
+	// Level with as many harmonics as possible below Nyquist at 'pitch'
+	SFM_INLINE static unsigned GetWavetableLevel(float pitch)
+	{
+		SFM_ASSERT(pitch >= 0.f);
+
+		// Highest harmonic (kWavetableMaxHarmonics >> level) times pitch must stay below 0.5, so level is ceil(log2(x))
+		int exponent;
+		const float mantissa = frexpf(pitch*(2*kWavetableMaxHarmonics), &exponent); // [0.5..1)
+		const int level = (0.5f == mantissa) ? exponent-1 : exponent;
+
+		return unsigned(std::clamp<int>(level, 0, kWavetableNumLevels-1));
+	}
+
+	// Phase is [0..1]
+	SFM_INLINE static float oscWavetable(const float *table, float phase)
+	{
+		SFM_ASSERT(phase >= 0.f && phase <= 1.f);
+
+		const float position = phase*kWavetableSize;
+		const unsigned index = unsigned(position);
+		SFM_ASSERT(index <= kWavetableSize);
+
+		const float fraction = position-index;
+		return lerpf<float>(table[index], table[index+1], fraction);
+	}
+}